@@ -2,8 +2,16 @@
 
 #include <BufferLayout.hpp>
 #include <Texture.hpp>
+#include <TextureBuffer.hpp>
 #include <VertexArray.hpp>
 #include <VertexBuffer.hpp>
+#include <StreamBuffer.hpp>
+#include <FrameArena.hpp>
+#include <GpuMemory.hpp>
+#include <MeshPool.hpp>
+#include <ShaderCache.hpp>
+#include <ShaderSource.hpp>
+#include <ShaderVariants.hpp>
 #include <Renderer.hpp>
 #include <Object.hpp>
 #include <Window.hpp>
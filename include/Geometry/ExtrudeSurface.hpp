@@ -19,10 +19,17 @@ public:
 
   glm::vec3 pointOnSurface(float u, float v) override;
 
+protected:
+  void _evaluateGrid(SurfaceLod &lod, uint rowFirst, uint rowLast,
+                     uint colFirst, uint colLast) override;
+  bool _getGpuSurface(GpuSurface &surface) override;
+
+public:
+
   void drawProperties() override;
   void drawGizmo() override;
 
-  void update();
+  void update() override;
 };
 
 } // namespace EGEOM
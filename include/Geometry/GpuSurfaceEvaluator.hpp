@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Ender.hpp>
+#include <vector>
+
+namespace EGEOM {
+
+// Must match SURFACE_* in surfaceEval.glsl.
+enum class GpuSurfaceType : int { Extrude, Rotation, Nurbs };
+
+// Everything the GPU needs to evaluate a surface. Extrude and rotation
+// surfaces are described by their curve (uDegree, uCount, u knots), NURBS
+// surfaces by the whole net.
+struct GpuSurface {
+  GpuSurfaceType type = GpuSurfaceType::Extrude;
+  int uDegree = 0;
+  int vDegree = 0;
+  int uCount = 0;
+  int vCount = 0;
+  // u knots followed by v knots.
+  std::vector<float> knots;
+  // (position * weight, weight).
+  std::vector<glm::vec4> controlPoints;
+  glm::vec3 extrudeVector{};
+  float rotationRadius = 0.0f;
+};
+
+// Evaluates surface grids with positions and analytic normals directly into
+// vertex buffers: with a compute shader on GL 4.3, otherwise with transform
+// feedback.
+class GpuSurfaceEvaluator {
+public:
+  enum class Backend { None, Compute, TransformFeedback };
+
+private:
+  bool _initialized = false;
+  Backend _backend = Backend::None;
+  sptr<ENDER::Shader> _program;
+
+  uptr<ENDER::TextureBuffer> _controlPoints;
+  uptr<ENDER::TextureBuffer> _knots;
+  uptr<ENDER::TextureBuffer> _params;
+  std::vector<float> _paramsData;
+
+  // Transform feedback draws need a bound vertex array.
+  sptr<ENDER::VertexArray> _emptyVertexArray;
+
+  bool _patchShadersCreated = false;
+  sptr<ENDER::Shader> _patchShader;
+  sptr<ENDER::Shader> _patchPickingShader;
+
+  GpuSurfaceEvaluator() = default;
+
+  void _init(Backend preferred);
+
+public:
+  static GpuSurfaceEvaluator &instance() {
+    static GpuSurfaceEvaluator _instance;
+    return _instance;
+  }
+
+  // Picks the best backend of the current context on the first call.
+  static Backend getBackend();
+
+  // Forces a backend, e.g. to test the transform feedback path on a 4.3
+  // context. Falls back to None when it cannot be used.
+  static void setBackend(Backend backend);
+
+  // Allocates vbo for us.size() * vs.size() vertices of two Float3 attributes
+  // (position, normal) and fills it. Returns false without a backend.
+  static bool evaluate(const GpuSurface &surface, const std::vector<float> &us,
+                       const std::vector<float> &vs,
+                       ENDER::VertexBuffer &vbo);
+
+  // Programs that draw GpuSurfacePatches, lit or into the picking texture.
+  // nullptr when the context has no tessellation stages.
+  static sptr<ENDER::Shader> getPatchShader(bool picking = false);
+
+  // Sets the uniforms of surfaceEval.glsl that describe the surface, the
+  // program must be in use.
+  static void setSurfaceUniforms(ENDER::Shader &program,
+                                 const GpuSurface &surface);
+};
+
+// A surface kept on the GPU and drawn as one patch per knot span cell. The
+// tessellation stages choose the density from the size of the patch on
+// screen, so nothing is tessellated on the CPU.
+class GpuSurfacePatches {
+  GpuSurface _surface;
+  uptr<ENDER::TextureBuffer> _controlPoints;
+  uptr<ENDER::TextureBuffer> _knots;
+  sptr<ENDER::VertexArray> _vertexArray;
+  std::vector<float> _corners;
+
+public:
+  // Uploads the surface and splits [uRange.x, uRange.y] x [vRange.x, vRange.y]
+  // into patches at its knots.
+  void upload(const GpuSurface &surface, const glm::vec2 &uRange,
+              const glm::vec2 &vRange);
+
+  // Binds the surface for a draw with a getPatchShader() program.
+  void bind(ENDER::Shader &shader, const glm::vec2 &viewportSize,
+            float pixelsPerSegment) const;
+
+  sptr<ENDER::VertexArray> getVertexArray() const { return _vertexArray; }
+  uint getPatchCount() const { return _corners.size() / 8; }
+};
+
+} // namespace EGEOM
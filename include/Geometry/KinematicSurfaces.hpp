@@ -20,7 +20,7 @@ private:
                    const sptr<Spline1> &guideSpline,
                    const KinematicSurfaceType &type);
 
-  glm::vec3 sweepSplineHelper(float v);
+  void _onDependencyChanged(bool alongU, float from, float to) override;
 
 public:
   static sptr<KinematicSurface> create(const std::string &name,
@@ -30,10 +30,15 @@ public:
 
   glm::vec3 pointOnSurface(float u, float v) override;
 
+protected:
+  void _evaluateGrid(SurfaceLod &lod, uint rowFirst, uint rowLast,
+                     uint colFirst, uint colLast) override;
+
+public:
   void drawProperties() override;
   void drawGizmo() override;
 
-  void update();
+  void update() override;
 };
 
 } // namespace EGEOM
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Surface.hpp"
+#include "Utils.hpp"
+namespace EGEOM {
+
+// Tensor-product NURBS surface. Control point (i, j) is stored at
+// i * vCount + j, i runs along u and j along v.
+class NurbsSurface : public Surface {
+  std::vector<glm::vec3> _controlPoints;
+  std::vector<float> _weights;
+  uint _uCount;
+  uint _vCount;
+  int _uDegree;
+  int _vDegree;
+  std::vector<float> _uKnots;
+  std::vector<float> _vKnots;
+
+  // Weighted control net in homogeneous coordinates.
+  std::vector<glm::vec4> _net;
+
+  uint64_t _knotVersion = 0;
+  BasisTableCache _uBasisTables;
+  BasisTableCache _vBasisTables;
+
+  NurbsSurface(const std::string &name,
+               const std::vector<glm::vec3> &controlPoints, uint uCount,
+               uint vCount, int uDegree, int vDegree,
+               const std::vector<float> &uKnots,
+               const std::vector<float> &vKnots,
+               const std::vector<float> &weights);
+
+  void _checkAndSetDefault();
+
+public:
+  static sptr<NurbsSurface>
+  create(const std::string &name, const std::vector<glm::vec3> &controlPoints,
+         uint uCount, uint vCount, int uDegree, int vDegree,
+         const std::vector<float> &uKnots = {},
+         const std::vector<float> &vKnots = {},
+         const std::vector<float> &weights = {});
+
+  glm::vec3 pointOnSurface(float u, float v) override;
+
+  glm::vec3 getControlPoint(uint i, uint j) const {
+    return _controlPoints[i * _vCount + j];
+  }
+  float getWeight(uint i, uint j) const { return _weights[i * _vCount + j]; }
+  uint getUCount() const { return _uCount; }
+  uint getVCount() const { return _vCount; }
+
+  // Moves a single control point, only the affected knot span is rebuilt.
+  void setControlPoint(uint i, uint j, const glm::vec3 &position,
+                       float weight);
+
+protected:
+  // Contracts the net with the u-basis once per column, then every node only
+  // needs the (vDegree + 1) v-basis weights of its row.
+  void _evaluateGrid(SurfaceLod &lod, uint rowFirst, uint rowLast,
+                     uint colFirst, uint colLast) override;
+  bool _getGpuSurface(GpuSurface &surface) override;
+
+public:
+  void drawProperties() override;
+
+  void update() override;
+};
+
+} // namespace EGEOM
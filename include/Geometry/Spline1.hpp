@@ -3,9 +3,28 @@
 #include <Ender.hpp>
 #include <Point.hpp>
 #include <SplineBuilder.hpp>
+#include <functional>
+#include <unordered_map>
 
 namespace EGEOM {
 
+// Number of samples the rotation minimizing frames are tabulated at.
+const uint SPLINE_FRAME_SAMPLES = 256;
+
+// Must match MAX_DEGREE of splineGpu.vs.
+const int SPLINE_GPU_MAX_DEGREE = 15;
+const int SPLINE_GPU_DEFAULT_SAMPLES = 1024;
+
+struct SplineFrame {
+  glm::vec3 point;
+  glm::vec3 tangent;
+  glm::vec3 normal;
+  glm::vec3 binormal;
+
+  // Columns are tangent, normal, binormal.
+  glm::mat3 basis() const { return glm::mat3{tangent, normal, binormal}; }
+};
+
 class Spline1 : public ENDER::Object {
 public:
   enum class ParamMethod { Uniform, Chordal, Centripetal };
@@ -18,15 +37,49 @@ public:
     NURBS
   };
 
+  // Receives the parameter interval of the curve that has changed.
+  typedef std::function<void(float, float)> changeCallback;
+
 private:
   int _interpolatedPointsCount;
   std::vector<sptr<Point>> _interpolatedPoints;
   std::vector<float> _rawData;
+  std::vector<float> _sampleParams;
 
   SplineType _splineType = SplineType::LinearInterpolation;
   uptr<SplineBuilder> _splineBuilder;
 
+  std::unordered_map<int, changeCallback> _changeCallbacks;
+  int _nextCallbackKey = 0;
+
+  // Incremented on every change of the curve shape.
+  uint64_t _version = 0;
+
+  // Rotation minimizing frames at SPLINE_FRAME_SAMPLES uniform parameters,
+  // valid while _framesVersion equals _version.
+  std::vector<SplineFrame> _frames;
+  uint64_t _framesVersion = 0;
+
+  const std::vector<SplineFrame> &_getFrameTable();
+
+  // In GPU mode the vertex shader evaluates the curve from control data kept
+  // in texture buffers; _interpolatedPoints are not updated then.
+  bool _gpuEvaluation = false;
+  int _gpuSamplesCount = SPLINE_GPU_DEFAULT_SAMPLES;
+  int _gpuDegree = 0;
+  std::vector<float> _gpuKnots;
+  std::vector<glm::vec4> _gpuControlPoints;
+  uptr<ENDER::TextureBuffer> _gpuKnotsBuffer;
+  uptr<ENDER::TextureBuffer> _gpuControlPointsBuffer;
+  sptr<ENDER::VertexArray> _gpuVertexArray;
+  sptr<ENDER::VertexArray> _lineVertexArray;
+
+  // Uploads the B-spline form of the curve, false if it has none.
+  bool _uploadGpuData();
+  void _setGpuMode(bool enabled);
+
   void _calculateDrawPoints();
+  void _notifyChanged(float from, float to);
 
   Spline1(const std::vector<sptr<Point>> &points, uint interpolatedPointsCount);
 
@@ -46,8 +99,42 @@ public:
 
   std::vector<sptr<Point>> getSplineDirs(float u, int dirsCount);
 
+  // Same as getSplineDirs, but allocated from the frame arena, so the result
+  // must not be kept past the current frame.
+  std::pmr::vector<glm::vec3> getSplineDerivatives(float u, int dirsCount);
+
+  // Evaluates the curve and its first dirsCount derivatives at every
+  // parameter, dirsCount + 1 values per parameter. B-splines reuse cached
+  // basis functions when the same parameters are requested again. The
+  // result is allocated from the frame arena.
+  std::pmr::vector<glm::vec3> evaluateBatch(const std::vector<float> &params,
+                                            int dirsCount = 0);
+
+  // Rotation minimizing frames (double reflection method) at the given
+  // parameters. The frames along the whole curve are computed once per
+  // curve version and shared by everyone asking; each query then takes a
+  // single reflection step from the nearest tabulated frame.
+  std::pmr::vector<SplineFrame>
+  getRotationMinimizingFrames(const std::vector<float> &params);
+
+  SplineFrame getRotationMinimizingFrame(float u);
+
   void setInterpolationPointsCount(uint count);
 
+  // Switches between CPU sampling and evaluation in the vertex shader. Only
+  // BSpline and NURBS curves up to SPLINE_GPU_MAX_DEGREE can be evaluated on
+  // the GPU, others stay on the CPU.
+  void setGpuEvaluation(bool enabled);
+  bool isGpuEvaluation() const { return _gpuEvaluation; }
+
+  void bindShaderResources(ENDER::Shader &shader) override;
+  uint64_t contentVersion() override { return _version; }
+
+  // The curve as a (rational) B-spline of degree <= SPLINE_GPU_MAX_DEGREE,
+  // false if it has no such form.
+  bool getBSplineForm(int &degree, std::vector<float> &knots,
+                      std::vector<glm::vec4> &controlPoints);
+
   void setSplineType(SplineType splineType);
 
   SplineType getSplineType() const;
@@ -60,6 +147,16 @@ public:
 
   void getPropertiesGUI(bool scrollToPoint);
 
+  int addChangeCallback(changeCallback callback);
+
+  void deleteChangeCallback(int key);
+
+  uint64_t getVersion() const { return _version; }
+
   void update();
+
+  // Cheaper update() for the case when only the control point with the given
+  // index has moved: resamples and re-uploads just the affected part.
+  void updatePoint(uint index);
 };
 } // namespace EGEOM
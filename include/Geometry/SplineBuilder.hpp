@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Point.hpp>
+#include <Utils.hpp>
+#include <memory_resource>
+#include <utility>
 #include <vector>
 namespace EGEOM {
 
@@ -11,15 +14,50 @@ public:
 
   virtual ~SplineBuilder() = default;
 
-  virtual sptr<Point> getSplinePoint(float t) = 0;
+  // Point of the curve at the parameter t.
+  virtual glm::vec3 evaluate(float t) = 0;
 
-  virtual std::vector<sptr<Point>> getSplineDerivatives(float t,
-                                                        int dirsCount) {
-    return {};
+  // Fills ders with the point and its first dirsCount derivatives at t.
+  // Builders without derivatives leave it empty.
+  virtual void evaluateDerivatives(float t, int dirsCount,
+                                   std::pmr::vector<glm::vec3> &ders) {
+    ders.clear();
   }
 
+  // Evaluates the curve at every parameter. For each of them dirsCount + 1
+  // values are written to out: the point and its derivatives. Builders
+  // without derivatives get a finite difference tangent, higher derivatives
+  // stay zero.
+  virtual void evaluateBatch(const std::vector<float> &params, int dirsCount,
+                             std::pmr::vector<glm::vec3> &out);
+
+  sptr<Point> getSplinePoint(float t);
+
+  std::vector<sptr<Point>> getSplineDerivatives(float t, int dirsCount);
+
   virtual void rebuild() = 0;
 
+  // Parameter interval of the curve that depends on the control point with
+  // the given index.
+  virtual std::pair<float, float> getAffectedInterval(uint index) {
+    return {0.0f, 1.0f};
+  }
+
+  // Called instead of rebuild() when only one control point was moved.
+  virtual void updatePoint(uint index) { rebuild(); }
+
+  // The curve written as a (rational) B-spline, used to evaluate it on the
+  // GPU. Control points are (position * weight, weight). Builders without
+  // such a form return false.
+  virtual bool getBSplineForm(int &degree, std::vector<float> &knots,
+                              std::vector<glm::vec4> &controlPoints) {
+    return false;
+  }
+
+  virtual glm::vec4 getHomogeneousPoint(uint index) {
+    return glm::vec4{points[index]->getPosition(), 1.0f};
+  }
+
   virtual bool drawPropertiesGui() = 0;
 };
 
@@ -38,7 +76,10 @@ public:
                              ParamMethod paramMethod);
   void rebuild() override;
 
-  sptr<Point> getSplinePoint(float t) override;
+  glm::vec3 evaluate(float t) override;
+
+  std::pair<float, float> getAffectedInterval(uint index) override;
+  void updatePoint(uint index) override;
 
   bool drawPropertiesGui() override;
 
@@ -52,11 +93,11 @@ private:
 /////////////////////////////////////
 
 class BezierBuilder : public SplineBuilder {
-  std::vector<float> _allBernstein(float u);
+  std::pmr::vector<float> _allBernstein(float u);
 
-  sptr<Point> _deCasteljau(float u);
+  glm::vec3 _deCasteljau(float u);
 
-  sptr<Point> pointWithAllBernstein(float u);
+  glm::vec3 pointWithAllBernstein(float u);
 
   std::vector<glm::vec3> _glmPoints;
 
@@ -66,9 +107,10 @@ public:
 
   BezierBuilder(const std::vector<sptr<Point>> &points, int bezierPower);
 
-  sptr<Point> getSplinePoint(float t) override;
+  glm::vec3 evaluate(float t) override;
 
   void rebuild() override;
+  void updatePoint(uint index) override;
 
   bool drawPropertiesGui() override;
 };
@@ -81,8 +123,8 @@ class RationalBezierBuilder : public SplineBuilder {
 private:
   std::vector<glm::vec3> _glmPoints;
 
-  std::vector<float> _allBernstein(float u);
-  sptr<Point> _deCasteljau(float u);
+  std::pmr::vector<float> _allBernstein(float u);
+  glm::vec3 _deCasteljau(float u);
 
 public:
   std::vector<float> w;
@@ -91,8 +133,9 @@ public:
   RationalBezierBuilder(const std::vector<sptr<Point>> &points, int bezierPower,
                         const std::vector<float> &weights);
 
-  sptr<Point> getSplinePoint(float t) override;
+  glm::vec3 evaluate(float t) override;
   void rebuild() override;
+  void updatePoint(uint index) override;
   bool drawPropertiesGui() override;
 };
 
@@ -103,6 +146,13 @@ public:
 class BSplineBuilder : public SplineBuilder {
   void _checkAndSetDefault();
 
+  // Bumped when a rebuild changes the knot vector or degree.
+  uint64_t _knotVersion = 0;
+  BasisTableCache _basisTables;
+  // Knots and degree the cached tables were computed for.
+  std::vector<float> _tableKnots;
+  int _tablePower = -1;
+
 public:
   int bSplinePower = 0;
   std::vector<float> knotVector = {};
@@ -110,10 +160,16 @@ public:
   BSplineBuilder(const std::vector<sptr<Point>> &points, int bSplinePower,
                  const std::vector<float> &knotVector);
 
-  sptr<Point> getSplinePoint(float t) override;
-  std::vector<sptr<Point>> getSplineDerivatives(float t,
-                                                int dirsCount) override;
+  glm::vec3 evaluate(float t) override;
+  void evaluateDerivatives(float t, int dirsCount,
+                           std::pmr::vector<glm::vec3> &ders) override;
+  void evaluateBatch(const std::vector<float> &params, int dirsCount,
+                     std::pmr::vector<glm::vec3> &out) override;
   void rebuild() override;
+  std::pair<float, float> getAffectedInterval(uint index) override;
+  void updatePoint(uint index) override;
+  bool getBSplineForm(int &degree, std::vector<float> &knots,
+                      std::vector<glm::vec4> &controlPoints) override;
   bool drawPropertiesGui() override;
 };
 
@@ -126,6 +182,14 @@ class RationalBSplineBuilder : public SplineBuilder {
   void _checkAndSetDefault();
   std::vector<glm::vec4> _glmPoints;
 
+  uint64_t _knotVersion = 0;
+  BasisTableCache _basisTables;
+  std::vector<float> _tableKnots;
+  int _tablePower = -1;
+
+  // Turns homogeneous derivatives into derivatives of the projected curve.
+  void _rationalDerivatives(const glm::vec4 *c4d, int du, glm::vec3 *ders);
+
 public:
   int bSplinePower = 0;
   std::vector<float> knotVector = {};
@@ -134,11 +198,18 @@ public:
   RationalBSplineBuilder(const std::vector<sptr<Point>> &points,
                          int bSplinePower, const std::vector<float> &knotVector,
                          const std::vector<float> &weights);
-  sptr<Point> getSplinePoint(float t) override;
+  glm::vec3 evaluate(float t) override;
 
-  std::vector<sptr<Point>> getSplineDerivatives(float t,
-                                                int dirsCount) override;
+  void evaluateDerivatives(float t, int dirsCount,
+                           std::pmr::vector<glm::vec3> &ders) override;
+  void evaluateBatch(const std::vector<float> &params, int dirsCount,
+                     std::pmr::vector<glm::vec3> &out) override;
   void rebuild() override;
+  std::pair<float, float> getAffectedInterval(uint index) override;
+  void updatePoint(uint index) override;
+  bool getBSplineForm(int &degree, std::vector<float> &knots,
+                      std::vector<glm::vec4> &controlPoints) override;
+  glm::vec4 getHomogeneousPoint(uint index) override;
   bool drawPropertiesGui() override;
 };
 } // namespace EGEOM
@@ -1,16 +1,223 @@
 #pragma once
 
 #include "Object.hpp"
+#include <Camera.hpp>
+#include <GpuSurfaceEvaluator.hpp>
+#include <Spline1.hpp>
 namespace EGEOM {
 
 const uint SURFACE_ROWS = 100;
 const uint SURFACE_COLS = 100;
 
+// Level 0 is SURFACE_ROWS x SURFACE_COLS, every next level halves both.
+const uint SURFACE_LOD_COUNT = 4;
+// Desired size of a single grid cell on screen.
+const float SURFACE_LOD_PIXELS_PER_CELL = 6.0f;
+// Coarser level is taken only when it is this much below the needed density.
+const float SURFACE_LOD_HYSTERESIS = 1.25f;
+
+// Floats per grid vertex: position followed by the normal.
+const uint SURFACE_VERTEX_SIZE = 6;
+// 32-bit words per compact vertex: 16-bit x, y, z (and padding), then the
+// normal packed as 10_10_10_2.
+const uint SURFACE_COMPACT_VERTEX_WORDS = 3;
+
+// Adaptive tessellation starts from this many segments in each direction.
+const uint SURFACE_MIN_SEGMENTS = 4;
+// Number of isolines the refinement criterion is probed along.
+const uint SURFACE_REFINE_PROBES = 9;
+// Largest allowed bend between neighbouring segments, ~10 degrees.
+const float SURFACE_MAX_BEND_ANGLE = 0.17f;
+
+struct SurfaceDependency {
+  sptr<Spline1> spline;
+  int callbackKey;
+  // Spline drives the u parameter, otherwise v.
+  bool alongU;
+  // Spline version the current geometry was built from.
+  uint64_t version;
+};
+
+struct SurfaceLod {
+  std::vector<float> us;
+  std::vector<float> vs;
+  // SURFACE_VERTEX_SIZE floats per node.
+  std::vector<float> vertices;
+  sptr<ENDER::VertexArray> vertexArray;
+  // Set when the grid was evaluated on the GPU, vertices are empty then.
+  // Owned by vertexArray.
+  ENDER::VertexBuffer *gpuBuffer = nullptr;
+  // Buffer holds compact vertices, positions as fractions of the box
+  // [quantMin, quantMin + quantExtent].
+  bool compact = false;
+  glm::vec3 quantMin{};
+  glm::vec3 quantExtent{1.0f};
+  // Set when the level lives in the renderer's mesh pool, vertexArray is the
+  // pool's then.
+  sptr<ENDER::PooledMesh> mesh;
+};
+
 class Surface : public ENDER::Object {
+protected:
+  float _uMin = 0.0f;
+  float _uMax = 1.0f;
+  float _vMin = 0.0f;
+  float _vMax = 1.0f;
+
+  std::vector<SurfaceLod> _lods;
+  uint _currentLod = 0;
+  int _forcedLod = -1;
+
+  bool _adaptive = true;
+  float _tolerance = 0.002f;
+
+  glm::vec3 _boundsCenter{};
+  float _boundsRadius = 0.0f;
+
+  bool _gpuTessellation = false;
+  bool _compactVertices = false;
+  bool _useMeshPool = true;
+
+  // Drawn as patches tessellated by the GPU at draw time, no grid is built.
+  bool _hardwareTessellation = false;
+  bool _drawingPatches = false;
+  GpuSurfacePatches _patches;
+  glm::vec2 _viewportSize{};
+
+  // Uploads the surface as patches when hardware tessellation is enabled and
+  // possible, returns false if the grid levels should be used instead.
+  bool _uploadPatches();
+
+  // Describes the surface for GpuSurfaceEvaluator, false if it can only be
+  // tessellated on the CPU.
+  virtual bool _getGpuSurface(GpuSurface &surface) { return false; }
+
+  // Bounds from a coarse grid, for levels whose vertices stay on the GPU.
+  void _estimateBounds();
+
+  // Parameter values of the grid lines along u (alongU) or v. The same values
+  // are used for every isoline, so the resulting grid has no T-junctions.
+  std::vector<float> _adaptiveParams(bool alongU, uint maxSegments,
+                                     float tolerance);
+  std::vector<float> _uniformParams(float min, float max, uint count) const;
+
+  std::vector<SurfaceDependency> _dependencies;
+
+  // Changes are collected here and applied once, right before the next draw.
+  bool _dirty = false;
+  bool _dirtyU = false;
+  bool _dirtyV = false;
+  glm::vec2 _dirtyURange{};
+  glm::vec2 _dirtyVRange{};
+  // Incremented every time collected changes are applied.
+  uint64_t _contentVersion = 0;
+
+  void _markRegionDirty(bool alongU, float from, float to);
+  void _flushChanges();
+
+  SurfaceLod _tessellate(std::vector<float> us, std::vector<float> vs);
+
+  // Fits the quantization box to the vertices of a compact level and uploads
+  // all of them.
+  void _quantize(SurfaceLod &lod);
+  std::pmr::vector<uint32_t> _packVertices(const SurfaceLod &lod, uint first,
+                                           uint count) const;
+  // Copies vertices [first, first + count) of the level to its buffer.
+  void _uploadVertices(SurfaceLod &lod, uint first, uint count);
+
+  // Writes vertices of the grid nodes in rows [rowFirst, rowLast) and
+  // columns [colFirst, colLast). The default calls pointOnSurface per node and
+  // takes the normal from central differences, subclasses evaluate their
+  // curves and derivatives once per row or column instead.
+  virtual void _evaluateGrid(SurfaceLod &lod, uint rowFirst, uint rowLast,
+                             uint colFirst, uint colLast);
+
+  // params[first, last), so that a block of the grid evaluates only the
+  // curve samples it covers.
+  static std::vector<float> _paramRange(const std::vector<float> &params,
+                                        uint first, uint last) {
+    return {params.begin() + first, params.begin() + last};
+  }
+
+  // du and dv are the partial derivatives at the node, their cross product
+  // gives the normal.
+  static void _setVertex(SurfaceLod &lod, uint row, uint col,
+                         const glm::vec3 &vertex, const glm::vec3 &du,
+                         const glm::vec3 &dv) {
+    auto normal = glm::cross(du, dv);
+    float length = glm::length(normal);
+    normal = length > 1e-12f ? normal / length : glm::vec3{0.0f, 0.0f, 1.0f};
+
+    auto index = (col + row * lod.us.size()) * SURFACE_VERTEX_SIZE;
+    lod.vertices[index] = vertex.x;
+    lod.vertices[index + 1] = vertex.y;
+    lod.vertices[index + 2] = vertex.z;
+    lod.vertices[index + 3] = normal.x;
+    lod.vertices[index + 4] = normal.y;
+    lod.vertices[index + 5] = normal.z;
+  }
+  sptr<ENDER::VertexArray> _getLod(uint level);
+  uint _selectLod(const ENDER::Camera &camera) const;
+
+  // Drops all built levels and rebuilds the active one. Must be called after
+  // anything that changes pointOnSurface.
+  void invalidate();
+
+  // Re-evaluates only the grid lines whose u (alongU) or v parameter lies in
+  // [from, to] and patches them in place.
+  void invalidateRegion(bool alongU, float from, float to);
+
+  // Subscribes to changes of the spline that drives the u (alongU) or v
+  // parameter of the surface.
+  void _addDependency(const sptr<Spline1> &spline, bool alongU);
+  virtual void _onDependencyChanged(bool alongU, float from, float to);
+
+  // Requests a full rebuild with update() before the next draw.
+  void markDirty();
+
 public:
   Surface(const std::string &name);
+  ~Surface();
 
   virtual glm::vec3 pointOnSurface(float u, float v) = 0;
+
+  // Recomputes cached state of the surface and rebuilds its geometry.
+  virtual void update() { invalidate(); }
+
+  bool isDirty() const;
+
+  // Grid size of a level as built, the nominal size if it is not built yet.
+  uint getLodRows(uint level) const;
+  uint getLodCols(uint level) const;
+  uint getCurrentLod() const { return _currentLod; }
+
+  // Evaluates the grid on the GPU when the surface and the context allow it.
+  void setGpuTessellation(bool enabled);
+
+  // Draws the surface with tessellation shaders when the surface and the
+  // context allow it, the density then follows the size on screen.
+  void setHardwareTessellation(bool enabled);
+
+  // Stores CPU-tessellated levels with quantized positions and packed
+  // normals, 12 bytes per vertex instead of 24.
+  void setCompactVertices(bool enabled);
+
+  // Keeps full-precision CPU levels in the renderer's mesh pool, where they
+  // are drawn together with other pooled surfaces.
+  void setMeshPool(bool enabled);
+
+  void setTolerance(float tolerance);
+  float getTolerance() const { return _tolerance; }
+
+  void prepareForRender(const ENDER::Camera &camera) override;
+  void bindShaderResources(ENDER::Shader &shader) override;
+  sptr<ENDER::Shader> getPickingShader() override;
+  const ENDER::PooledMesh *getPooledMesh() override;
+  sptr<ENDER::VertexArray>
+  getTriangleFallback(const ENDER::PooledMesh *&mesh) override;
+  uint64_t contentVersion() override { return _contentVersion; }
+
+  void drawProperties() override;
 };
 
 } // namespace EGEOM
@@ -1,69 +1,75 @@
 #pragma once
 #include <assert.h>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
 #include <vector>
 
 namespace EGEOM {
-int bSplineFindSpan(int n, int p, float u, std::vector<float> U);
-std::vector<float> bSplineBasisFunc(int i, float u, int p,
-                                    std::vector<float> U);
+int bSplineFindSpan(int n, int p, float u, const std::vector<float> &U);
 
-template <typename T> class Matrix {
-  class MatrixRow {
-    T *data_ = nullptr;
-    int size_;
-
-  public:
-    MatrixRow(int n) : size_(n) { data_ = new T[size_](); }
-
-    MatrixRow(const std::initializer_list<T> &il)
-        : size_(il.size()), data_(new T[size_]) {
-      auto i = 0;
-      for (T el : il) {
-        data_[i] = el;
-        i++;
-      }
-    }
-
-    MatrixRow() : size_(0) {}
-
-    ~MatrixRow() { delete[] data_; }
+// Scratch results are allocated from the frame arena of the calling thread.
+std::pmr::vector<float> bSplineBasisFunc(int i, float u, int p,
+                                         const std::vector<float> &U);
 
-    T &operator[](int i) {
-      assert(i < size_);
-      return data_[i];
-    }
-  };
-
-  MatrixRow *rows_;
+template <typename T> class Matrix {
+  std::pmr::vector<T> data_;
   int n_;
   int m_;
 
 public:
-  Matrix(int n, int m) : n_(n), m_(m), rows_(new MatrixRow[n]) {
-    for (auto i = 0; i < n_; ++i) {
-      rows_[i] = *(new MatrixRow(m));
-    }
-  }
+  Matrix(int n, int m,
+         std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : data_(n * m, T(), resource), n_(n), m_(m) {}
 
   Matrix(const std::initializer_list<std::initializer_list<T>> &il)
-      : n_(il.size()) {
-    rows_ = new MatrixRow[il.size()]{};
-    auto i = 0;
+      : n_(il.size()), m_(il.size() > 0 ? il.begin()->size() : 0) {
     for (auto row : il) {
-      rows_[i] = *(new MatrixRow(row));
-      i++;
+      assert(row.size() == m_);
+      data_.insert(data_.end(), row.begin(), row.end());
     }
   }
 
-  ~Matrix() { delete[] rows_; }
-
-  MatrixRow &operator[](int i) {
+  T *operator[](int i) {
     assert(i < n_);
-    return rows_[i];
+    return &data_[i * m_];
   }
 };
 
 int binomialCoeff(int n, int k);
 
-Matrix<float> dersBasisFunc(int i, float u, int p, int n, std::vector<float> U);
+Matrix<float> dersBasisFunc(int i, float u, int p, int n,
+                            const std::vector<float> &U);
+
+// Nonzero basis functions (and their derivatives) of a B-spline sampled at a
+// fixed set of parameters. Stays valid while the knot vector is unchanged, so
+// moving control points only needs a sparse product with the table.
+struct BasisTable {
+  uint64_t knotVersion = 0;
+  int degree = 0;
+  int derivatives = 0;
+  std::vector<float> params;
+  std::vector<int> spans;
+  // Per sample (derivatives + 1) rows of (degree + 1) weights.
+  std::vector<float> weights;
+
+  const float *sampleWeights(int sample, int derivative) const {
+    return &weights[(sample * (derivatives + 1) + derivative) * (degree + 1)];
+  }
+};
+
+const unsigned int BASIS_TABLE_CACHE_SIZE = 8;
+
+class BasisTableCache {
+  // Most recently used table is the last one.
+  std::vector<BasisTable> _tables;
+
+public:
+  // n is the index of the last control point, U the knot vector.
+  const BasisTable &get(uint64_t knotVersion, int degree, int derivatives,
+                        const std::vector<float> &params, int n,
+                        const std::vector<float> &U);
+
+  void clear() { _tables.clear(); }
+};
 } // namespace EGEOM
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "spdlog/spdlog.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <glad/glad.h>
@@ -13,7 +14,61 @@ namespace ENDER
     Float1,
     Float2,
     Float3,
-    Float4
+    Float4,
+    // Half floats, there is no Half3 as attributes should stay 4-byte aligned.
+    Half2,
+    Half4,
+    // Integers read by the shader as floats in [-1, 1] (signed) or [0, 1].
+    Short2Norm,
+    Short4Norm,
+    UShort2Norm,
+    UShort4Norm,
+    Byte4Norm,
+    UByte4Norm,
+    // x, y, z in 10 bits each and w in 2, e.g. packed normals.
+    Int2_10_10_10Norm,
+    // Read by the shader as an integer, e.g. an index.
+    UInt1
+  };
+
+  // How often the contents of a buffer change. Static data is uploaded once,
+  // dynamic data is rewritten or appended to now and then and keeps spare
+  // capacity, stream data is rewritten as a whole often. Such rewrites are
+  // staged in a shared StreamBuffer and copied on the GPU, partial updates go
+  // to the buffer directly like dynamic ones.
+  enum class BufferUsage
+  {
+    Static,
+    Dynamic,
+    Stream
+  };
+
+  inline unsigned int convertUsageToGLUsage(BufferUsage usage)
+  {
+    switch (usage)
+    {
+    case BufferUsage::Static:
+      return GL_STATIC_DRAW;
+    case BufferUsage::Dynamic:
+      return GL_DYNAMIC_DRAW;
+    case BufferUsage::Stream:
+      return GL_STREAM_DRAW;
+    default:
+      spdlog::error("Unknown BufferUsage");
+      throw;
+    }
+  }
+
+  // Attribute locations the renderer's shaders agree on.
+  enum class AttributeLocation : int
+  {
+    Position = 0,
+    Normal = 1,
+    TexCoord = 2,
+    // Index of the draw in a multi-draw, see MeshPool.
+    DrawId = 3,
+    // Per-instance object space offset, see ShaderFeature::Instanced.
+    InstanceOffset = 4
   };
 
   struct LayoutObject
@@ -22,13 +77,24 @@ namespace ENDER
     unsigned int size = 0;
     unsigned int stride = 0;
     size_t offset = 0;
+    // Shader attribute location, -1 takes the one after the previous attribute
+    // of the vertex array.
+    int location = -1;
 
-    LayoutObject(const LayoutObjectType &obj_type) { type = obj_type; }
+    LayoutObject(const LayoutObjectType &obj_type, int obj_location = -1)
+    {
+      type = obj_type;
+      location = obj_location;
+    }
+    LayoutObject(const LayoutObjectType &obj_type, AttributeLocation obj_location)
+        : LayoutObject(obj_type, static_cast<int>(obj_location)) {}
   };
 
   class BufferLayout
   {
     std::vector<LayoutObject> _layout;
+    // Attributes advance once per this many instances, 0 means per vertex.
+    unsigned int _divisor = 0;
 
     void calculateLayoutProperties()
     {
@@ -48,8 +114,8 @@ namespace ENDER
     }
 
   public:
-    BufferLayout(const std::initializer_list<LayoutObject> &objects)
-        : _layout(objects)
+    BufferLayout(const std::initializer_list<LayoutObject> &objects, unsigned int divisor = 0)
+        : _layout(objects), _divisor(divisor)
     {
       calculateLayoutProperties();
       spdlog::info("Created new buffer layout");
@@ -60,7 +126,13 @@ namespace ENDER
       spdlog::info("Deallocated BufferLayout");
     }
 
-    void addObject(const LayoutObject &object) { _layout.push_back(object); }
+    void addObject(const LayoutObject &object)
+    {
+      _layout.push_back(object);
+      calculateLayoutProperties();
+    }
+
+    unsigned int getDivisor() const { return _divisor; }
 
     void debugPrint() const
     {
@@ -68,9 +140,9 @@ namespace ENDER
       auto i = 0;
       for (auto &el : _layout)
       {
-        spdlog::debug("Element {}: Type: {}, Size: {}, Stride: {}, Offset: {}", i,
+        spdlog::debug("Element {}: Type: {}, Size: {}, Stride: {}, Offset: {}, Location: {}", i,
                       convertTypeToString(el.type), el.size, el.stride,
-                      el.offset);
+                      el.offset, el.location);
       }
     }
 
@@ -83,6 +155,19 @@ namespace ENDER
       case LayoutObjectType::Float3:
       case LayoutObjectType::Float4:
         return convertTypeToNumberOfElements(type) * sizeof(float);
+      case LayoutObjectType::Half2:
+      case LayoutObjectType::Half4:
+      case LayoutObjectType::Short2Norm:
+      case LayoutObjectType::Short4Norm:
+      case LayoutObjectType::UShort2Norm:
+      case LayoutObjectType::UShort4Norm:
+        return convertTypeToNumberOfElements(type) * sizeof(uint16_t);
+      case LayoutObjectType::Byte4Norm:
+      case LayoutObjectType::UByte4Norm:
+        return convertTypeToNumberOfElements(type) * sizeof(uint8_t);
+      case LayoutObjectType::Int2_10_10_10Norm:
+      case LayoutObjectType::UInt1:
+        return sizeof(uint32_t);
       default:
         spdlog::error("Unknown LayoutObjectType");
         throw;
@@ -97,6 +182,23 @@ namespace ENDER
       case LayoutObjectType::Float3:
       case LayoutObjectType::Float4:
         return GL_FLOAT;
+      case LayoutObjectType::Half2:
+      case LayoutObjectType::Half4:
+        return GL_HALF_FLOAT;
+      case LayoutObjectType::Short2Norm:
+      case LayoutObjectType::Short4Norm:
+        return GL_SHORT;
+      case LayoutObjectType::UShort2Norm:
+      case LayoutObjectType::UShort4Norm:
+        return GL_UNSIGNED_SHORT;
+      case LayoutObjectType::Byte4Norm:
+        return GL_BYTE;
+      case LayoutObjectType::UByte4Norm:
+        return GL_UNSIGNED_BYTE;
+      case LayoutObjectType::Int2_10_10_10Norm:
+        return GL_INT_2_10_10_10_REV;
+      case LayoutObjectType::UInt1:
+        return GL_UNSIGNED_INT;
       default:
         spdlog::error("Unknown LayoutObjectType");
         throw;
@@ -107,12 +209,22 @@ namespace ENDER
       switch (type)
       {
       case LayoutObjectType::Float1:
+      case LayoutObjectType::UInt1:
         return 1;
       case LayoutObjectType::Float2:
+      case LayoutObjectType::Half2:
+      case LayoutObjectType::Short2Norm:
+      case LayoutObjectType::UShort2Norm:
         return 2;
       case LayoutObjectType::Float3:
         return 3;
       case LayoutObjectType::Float4:
+      case LayoutObjectType::Half4:
+      case LayoutObjectType::Short4Norm:
+      case LayoutObjectType::UShort4Norm:
+      case LayoutObjectType::Byte4Norm:
+      case LayoutObjectType::UByte4Norm:
+      case LayoutObjectType::Int2_10_10_10Norm:
         return 4;
       default:
         spdlog::error("Unknown LayoutObjectType");
@@ -131,11 +243,54 @@ namespace ENDER
         return "Float3";
       case LayoutObjectType::Float4:
         return "Float4";
+      case LayoutObjectType::Half2:
+        return "Half2";
+      case LayoutObjectType::Half4:
+        return "Half4";
+      case LayoutObjectType::Short2Norm:
+        return "Short2Norm";
+      case LayoutObjectType::Short4Norm:
+        return "Short4Norm";
+      case LayoutObjectType::UShort2Norm:
+        return "UShort2Norm";
+      case LayoutObjectType::UShort4Norm:
+        return "UShort4Norm";
+      case LayoutObjectType::Byte4Norm:
+        return "Byte4Norm";
+      case LayoutObjectType::UByte4Norm:
+        return "UByte4Norm";
+      case LayoutObjectType::Int2_10_10_10Norm:
+        return "Int2_10_10_10Norm";
+      case LayoutObjectType::UInt1:
+        return "UInt1";
       default:
         spdlog::error("Unknown LayoutObjectType");
         throw;
       }
     }
+    // Integer types that glVertexAttribPointer should map to [-1, 1] or [0, 1].
+    static bool isNormalized(const LayoutObjectType &type)
+    {
+      switch (type)
+      {
+      case LayoutObjectType::Short2Norm:
+      case LayoutObjectType::Short4Norm:
+      case LayoutObjectType::UShort2Norm:
+      case LayoutObjectType::UShort4Norm:
+      case LayoutObjectType::Byte4Norm:
+      case LayoutObjectType::UByte4Norm:
+      case LayoutObjectType::Int2_10_10_10Norm:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    // Integer attributes are not converted to floats.
+    static bool isInteger(const LayoutObjectType &type)
+    {
+      return type == LayoutObjectType::UInt1;
+    }
 
     auto begin() { return _layout.begin(); }
 
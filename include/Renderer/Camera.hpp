@@ -11,6 +11,7 @@ namespace ENDER {
         virtual glm::vec3 getPosition() const = 0;
         virtual glm::vec3 getFront() const = 0;
         virtual bool getSpotlightToggled() const = 0;
+        virtual glm::vec2 getFramebufferSize() const = 0;
 
     };
 }
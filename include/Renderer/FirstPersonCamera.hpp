@@ -51,6 +51,7 @@ namespace ENDER {
         glm::vec3 getFront() const override;
 
         bool getSpotlightToggled() const override;
+        glm::vec2 getFramebufferSize() const override;
 
         void proccessInput();
         void proccessMouseInput(double xpos, double ypos);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace ENDER {
+
+const size_t FRAME_ARENA_BLOCK_SIZE = 256 * 1024;
+// Largest block reset() keeps for the next frame, one large edit should not
+// pin its scratch memory for the rest of the session.
+const size_t FRAME_ARENA_MAX_RETAINED_SIZE = 4 * 1024 * 1024;
+
+// Bump allocator for scratch data that lives no longer than a frame.
+// Deallocation is a no-op, memory is reclaimed by rewinding to a mark() at
+// the end of each evaluation (see FrameArenaScope) and all at once by
+// reset().
+class FrameArena : public std::pmr::memory_resource {
+public:
+  typedef std::function<void(size_t)> allocationHook;
+
+  struct Stats {
+    size_t bytesUsed = 0;
+    size_t peakBytesUsed = 0;
+    size_t bytesReserved = 0;
+    // Blocks the arena itself took from the heap.
+    unsigned int blockAllocations = 0;
+    // Heap allocations of the thread, in and outside the arena. Counted only
+    // in builds with ENDER_COUNT_HEAP_ALLOCATIONS, zero otherwise.
+    size_t heapAllocations = 0;
+  };
+
+  struct Marker {
+    size_t block;
+    size_t offset;
+    size_t bytesUsed;
+  };
+
+private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> _blocks;
+  size_t _currentBlock = 0;
+  size_t _offset = 0;
+
+  Stats _stats;
+  Stats _lastFrameStats;
+  size_t _frameHeapAllocations = 0;
+
+  static allocationHook _allocationHook;
+
+  void _addBlock(size_t size);
+
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+public:
+  FrameArena(size_t blockSize = FRAME_ARENA_BLOCK_SIZE);
+
+  // Invalidates everything allocated since the previous reset. If the frame
+  // did not fit into the first block it is grown, up to
+  // FRAME_ARENA_MAX_RETAINED_SIZE, so the next frame does not touch the heap.
+  void reset();
+
+  Marker mark() const;
+  // Invalidates everything allocated since the mark was taken.
+  void rewind(const Marker &marker);
+
+  const Stats &stats() const { return _stats; }
+  const Stats &lastFrameStats() const { return _lastFrameStats; }
+
+  // Heap allocations made by the calling thread so far, as reported through
+  // countHeapAllocation().
+  static size_t heapAllocations();
+  static void countHeapAllocation();
+
+  // Arena of the calling thread.
+  static FrameArena &local();
+
+  // Called with the size of every block the arena takes from the heap.
+  static void setAllocationHook(allocationHook hook);
+};
+
+// Gives back everything allocated from the thread's arena during its
+// lifetime. Nothing allocated inside may outlive it, which includes growth of
+// arena containers created outside.
+class FrameArenaScope {
+  FrameArena &_arena;
+  FrameArena::Marker _marker;
+
+public:
+  FrameArenaScope() : _arena(FrameArena::local()), _marker(_arena.mark()) {}
+  ~FrameArenaScope() { _arena.rewind(_marker); }
+
+  FrameArenaScope(const FrameArenaScope &) = delete;
+  FrameArenaScope &operator=(const FrameArenaScope &) = delete;
+};
+
+} // namespace ENDER
@@ -1,20 +1,42 @@
 #pragma once
 #include "PickingTexture.hpp"
 #include <ender_types.hpp>
+#include <glm/glm.hpp>
 
 namespace ENDER {
+    // Attachments are allocated in steps of this many pixels, so resizing a
+    // panel reallocates them only when it crosses a step.
+    static const unsigned int FRAMEBUFFER_SIZE_STEP = 64;
+
     class Framebuffer {
         uint _id;
         uint _rid;
         uint _tid;
 
-        float _width;
-        float _height;
+        // Size of the image, drawn to the bottom left corner of the
+        // attachments.
+        uint _width;
+        uint _height;
+        // Size the attachments are allocated with.
+        uint _allocatedWidth = 0;
+        uint _allocatedHeight = 0;
 
         sptr<PickingTexture> _pickingTexture;
 
+        // Renderer::contentVersion() of what the attachments hold, valid
+        // until the next reallocation.
+        uint64_t _contentVersion = 0;
+        bool _contentValid = false;
+
         Framebuffer(float width, float height);
 
+        // Reports attachment sizes to GpuMemory.
+        void _trackSizes();
+
+        // Whole pixels covering size, at least one.
+        static uint _pixels(float size);
+        static uint _roundSize(float size);
+
     public:
         ~Framebuffer();
 
@@ -24,6 +46,10 @@ namespace ENDER {
 
         uint getTextureId();
 
+        // Texture coordinates of the top right corner of the image, e.g. for
+        // ImGui::Image.
+        glm::vec2 getTextureScale() const;
+
         sptr<PickingTexture> getPickingTexture();
 
         void clear();
@@ -35,7 +61,15 @@ namespace ENDER {
         // here we unbind our framebuffer
         void unbind();
 
-        // and we rescale the buffer, so we're able to resize the window
+        // Changes the image size, the attachments are reallocated only when
+        // it no longer fits them or takes less than half of them.
         void rescale(float width, float height);
+
+        // False when the attachments already hold an image of the given
+        // content version, so the previous frame can be shown again.
+        bool needsRender(uint64_t contentVersion) const;
+        void setContentVersion(uint64_t contentVersion);
+        // Forces the next needsRender() to return true.
+        void invalidate();
     };
 }
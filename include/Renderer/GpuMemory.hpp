@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ENDER
+{
+  enum class GpuResourceKind
+  {
+    Buffer,
+    Texture,
+    Renderbuffer,
+    Framebuffer,
+    VertexArray
+  };
+
+  // Registry of the GL objects the renderer allocates, to see what takes video
+  // memory and what keeps growing. Sizes are estimates of the storage the
+  // object was given, drivers may pad them.
+  class GpuMemory
+  {
+  public:
+    struct Allocation
+    {
+      GpuResourceKind kind;
+      unsigned int id;
+      size_t bytes;
+      std::string owner;
+      uint64_t frame;
+    };
+
+    // Labels every resource registered on this thread while it is alive,
+    // scopes nest.
+    class OwnerScope
+    {
+      std::string _previous;
+
+    public:
+      OwnerScope(const std::string &owner);
+      ~OwnerScope();
+    };
+
+  private:
+    static std::map<std::pair<GpuResourceKind, unsigned int>, Allocation> _allocations;
+    static uint64_t _frame;
+
+  public:
+    static void add(GpuResourceKind kind, unsigned int id, size_t bytes = 0);
+    static void resize(GpuResourceKind kind, unsigned int id, size_t bytes);
+    static void remove(GpuResourceKind kind, unsigned int id);
+    // For objects recreated under a new name, e.g. grown buffers. Owner and
+    // creation frame are kept.
+    static void move(GpuResourceKind kind, unsigned int from, unsigned int to, size_t bytes);
+
+    // Called once per frame by the renderer.
+    static void nextFrame() { _frame++; }
+    static uint64_t frame() { return _frame; }
+
+    static size_t totalBytes();
+    static size_t totalBytes(GpuResourceKind kind);
+    static size_t count(GpuResourceKind kind);
+
+    // Allocations sorted by size, largest first.
+    static std::vector<Allocation> snapshot();
+
+    // Logs totals per kind and every allocation.
+    static void dump();
+
+    // ImGui contents: totals per kind and a table of allocations. Meant to be
+    // called inside a window.
+    static void drawPanel();
+
+    static const char *kindToString(GpuResourceKind kind);
+  };
+} // namespace ENDER
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <BufferLayout.hpp>
+#include <GpuMemory.hpp>
 #include <spdlog/spdlog.h>
 
 namespace ENDER
@@ -9,11 +11,25 @@ namespace ENDER
   {
     unsigned int _id;
     unsigned int _count;
+    unsigned int _capacity;
+    BufferUsage _usage;
 
   public:
-    IndexBuffer(unsigned int *indices, unsigned int count);
+    // Stream usage is only a hint here, index buffers are not ring-buffered.
+    IndexBuffer(unsigned int *indices, unsigned int count,
+                BufferUsage usage = BufferUsage::Static);
     ~IndexBuffer();
 
+    // Dynamic buffers keep their storage while the indices fit into it.
+    void setData(unsigned int *indices, unsigned int count);
+
+    // Overwrites indices [first, first + count).
+    void setSubData(unsigned int first, const unsigned int *indices, unsigned int count);
+
+    // Changes the count keeping the indices in front, new ones are undefined.
+    // The buffer keeps its name, so vertex arrays need no update.
+    void resize(unsigned int count);
+
     void bind();
     void unbind();
 
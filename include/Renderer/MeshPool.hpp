@@ -0,0 +1,112 @@
+#pragma once
+
+#include <StreamBuffer.hpp>
+#include <VertexArray.hpp>
+#include <ender_types.hpp>
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace ENDER
+{
+  class MeshPool;
+
+  // Floats per pooled vertex: position followed by the normal.
+  const uint MESH_POOL_VERTEX_SIZE = 6;
+  const uint MESH_POOL_INITIAL_VERTICES = 64 * 1024;
+  const uint MESH_POOL_INITIAL_INDICES = 384 * 1024;
+
+  // Triangle mesh sub-allocated from a MeshPool, freed when the last
+  // reference goes away. Indices are relative to baseVertex.
+  class PooledMesh
+  {
+    friend class MeshPool;
+    std::weak_ptr<MeshPool> _pool;
+
+  public:
+    uint baseVertex = 0;
+    uint vertexCount = 0;
+    uint firstIndex = 0;
+    uint indexCount = 0;
+
+    ~PooledMesh();
+
+    // Vertices [first, first + count), MESH_POOL_VERTEX_SIZE floats each.
+    void setVertices(uint first, const float *vertices, uint count);
+    void setIndices(const unsigned int *indices);
+  };
+
+  // Per-draw data of a multi-draw, std430 layout of DrawData in meshPool.vs.
+  struct MeshDrawData
+  {
+    glm::mat4 model;
+    // mat3 columns are padded to vec4 in std430.
+    glm::mat4 normalMatrix;
+    // Shininess in w.
+    glm::vec4 diffuse;
+    // 1 in w for selected objects.
+    glm::vec4 ambient;
+    glm::vec4 specular;
+  };
+
+  // Shared vertex and index buffers for meshes with the same layout, so that
+  // all of them are drawn by one glMultiDrawElementsIndirect. The vertex
+  // array also carries a per-instance draw index at AttributeLocation::DrawId,
+  // every command starts its instance at its own index (baseInstance), and
+  // the shader fetches its MeshDrawData with it.
+  class MeshPool : public std::enable_shared_from_this<MeshPool>
+  {
+    friend class PooledMesh;
+
+    struct DrawCommand
+    {
+      uint count;
+      uint instanceCount;
+      uint firstIndex;
+      int baseVertex;
+      uint baseInstance;
+    };
+
+    // Buffer 0 holds the vertices, buffer 1 the draw indices 0, 1, 2, ...
+    sptr<VertexArray> _vertexArray;
+    uint _vertexCapacity = 0;
+    uint _indexCapacity = 0;
+    uint _drawIdCapacity = 0;
+
+    // Free ranges, offset -> length.
+    std::map<uint, uint> _freeVertices;
+    std::map<uint, uint> _freeIndices;
+
+    std::vector<DrawCommand> _commands;
+    std::vector<MeshDrawData> _drawData;
+    StreamBuffer _commandBuffer{GL_DRAW_INDIRECT_BUFFER};
+    StreamBuffer _drawDataBuffer{GL_SHADER_STORAGE_BUFFER};
+
+    MeshPool();
+
+    static bool _allocate(std::map<uint, uint> &freeRanges, uint count, uint &offset);
+    static void _free(std::map<uint, uint> &freeRanges, uint offset, uint count);
+    void _growVertices(uint capacity);
+    void _growIndices(uint capacity);
+    void _growDrawIds(uint capacity);
+
+  public:
+    static sptr<MeshPool> create();
+
+    // Multi-draw indirect needs GL 4.3.
+    static bool isSupported();
+
+    sptr<PooledMesh> allocate(uint vertexCount, uint indexCount);
+
+    const sptr<VertexArray> &getVertexArray() const { return _vertexArray; }
+
+    // Queues a draw of the mesh for the next flush.
+    void addDraw(const PooledMesh &mesh, const MeshDrawData &data);
+    uint queuedDraws() const { return _commands.size(); }
+
+    // Draws everything queued with the bound program in one call, the
+    // MeshDrawData array is bound to shader storage binding 0.
+    void flush(unsigned int drawType = GL_TRIANGLES);
+  };
+} // namespace ENDER
@@ -7,6 +7,9 @@
 #include <glm/glm.hpp>
 
 namespace ENDER {
+class Camera;
+class PooledMesh;
+
 class Object {
 public:
   enum class ObjectType { Surface, Line, Multi };
@@ -91,6 +94,34 @@ public:
 
   virtual void drawGizmo() {}
 
+  // Called by the renderer right before the object is drawn with the given
+  // camera, e.g. to pick a level of detail.
+  virtual void prepareForRender(const Camera &camera) {}
+
+  // Called after the renderer has set its uniforms on the shader the object
+  // is drawn with, to bind textures and uniforms of the object itself.
+  virtual void bindShaderResources(Shader &shader) {}
+
+  // Program that writes the object into the picking texture, nullptr for the
+  // renderer's default one.
+  virtual sptr<Shader> getPickingShader() { return nullptr; }
+
+  // Mesh pool range the vertex array is drawn from, nullptr when the object
+  // has a vertex array of its own.
+  virtual const PooledMesh *getPooledMesh() { return nullptr; }
+
+  // Triangles drawn instead of a patch vertex array by passes whose shader
+  // has no tessellation stages, nullptr when the object has none. mesh is
+  // set when they are a range of the renderer's mesh pool.
+  virtual sptr<VertexArray> getTriangleFallback(const PooledMesh *&mesh) {
+    return nullptr;
+  }
+
+  // Changes whenever the object draws differently for reasons the renderer
+  // can't see on its own, e.g. data it binds in bindShaderResources. The
+  // transform, material, texture and vertex array are tracked already.
+  virtual uint64_t contentVersion() { return 0; }
+
   std::string getName() const;
 
   static sptr<Object> create(const std::string &name,
@@ -51,6 +51,7 @@ namespace ENDER{
         }
 
         bool getSpotlightToggled() const override;
+        glm::vec2 getFramebufferSize() const override;
 
 
         void proccessMouseInput(double xpos, double ypos);
@@ -39,6 +39,9 @@ namespace ENDER {
         GLuint _fbo = 0;
         GLuint _pickingTexture = 0;
         GLuint _depthTexture = 0;
+
+        // Reports attachment sizes to GpuMemory.
+        void _trackSizes(unsigned int width, unsigned int height);
     };
 
 }
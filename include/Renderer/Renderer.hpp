@@ -1,11 +1,13 @@
 #pragma once
 #include "DirectionalLight.hpp"
 #include "PointLight.hpp"
+#include "MeshPool.hpp"
 #include "VertexArray.hpp"
 #include <Object.hpp>
 #include <Renderer/PickingTexture.hpp>
 #include <Scene.hpp>
 #include <Shader.hpp>
+#include <ShaderVariants.hpp>
 #include <Window.hpp>
 
 #include "Framebuffer.hpp"
@@ -30,13 +32,16 @@ private:
 
   DrawType _drawType = DrawType::Triangles;
 
-  sptr<Shader> _simpleShader;
-  sptr<Shader> _textureShader;
+  // Surfaces, lines and picking, object.vs / object.fs permutations.
+  sptr<ShaderVariants> _objectShaders;
   sptr<Shader> _gridShader;
-  sptr<Shader> _pickingEffect;
   sptr<Shader> _debugSquareShader;
   sptr<Shader> _debugNormalsShader;
-  sptr<Shader> _simpleShaderLine;
+  sptr<Shader> _splineShader;
+  sptr<Shader> _meshPoolShader;
+
+  // Null without multi-draw indirect support.
+  sptr<MeshPool> _meshPool;
 
   glm::mat4 _projectMatrix;
 
@@ -65,6 +70,20 @@ private:
 
   void _configureLight(sptr<Shader> shader, sptr<Scene> scene);
 
+  // Instanced for vertex arrays with per-instance offsets, 0 otherwise.
+  static unsigned int _instancedFeature(VertexArray &vertexArray);
+
+  // Indexed or not, instanced when the vertex array has instanced buffers.
+  // With a pooled mesh only its range of the pool's vertex array is drawn.
+  void _draw(VertexArray &vertexArray, unsigned int drawType,
+             const PooledMesh *mesh = nullptr);
+
+  // Draws surfaces from the mesh pool that need nothing but the default
+  // lighting in one multi-draw, then everything else object by object.
+  void _renderObjects(sptr<Scene> scene);
+
+  static void _hashObject(uint64_t &seed, Object &object, const Camera &camera);
+
 
   bool _renderNormals = false;
 
@@ -107,6 +126,13 @@ public:
   static void renderScene(sptr<Scene> scene);
   static void renderObject(sptr<Object> object, sptr<Scene> scene, sptr<Framebuffer> framebuffer);
 
+  // Hash of everything that renderScene() and renderObject() calls for the
+  // given extra objects would draw: camera, lights and objects. Equal values
+  // mean the framebuffer would get the same image. Objects are prepared for
+  // rendering, as drawing them would.
+  static uint64_t contentVersion(sptr<Scene> scene,
+                                 const std::vector<sptr<Object>> &objects = {});
+
 
   static unsigned int pickObjAt(uint x, uint y, uint window_height);
 
@@ -115,6 +141,8 @@ public:
   static void pickingResize(float width, float height);
 
   static sptr<Shader> getGridShader() { return instance()._gridShader; }
+  static sptr<Shader> getSplineShader() { return instance()._splineShader; }
+  static sptr<MeshPool> getMeshPool() { return instance()._meshPool; }
 
   static sptr<VertexArray> getCubeVAO() { return instance().cubeVAO; }
   static sptr<VertexArray> getGridVAO() { return instance().gridVAO; }
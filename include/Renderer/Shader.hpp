@@ -5,11 +5,14 @@
 #include <memory>
 #include <spdlog/spdlog.h>
 #include <ender_types.hpp>
+#include <ShaderCache.hpp>
+#include <ShaderSource.hpp>
 
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 namespace ENDER
 {
@@ -17,107 +20,138 @@ namespace ENDER
     {
     public:
         unsigned int ID;
-        // constructor generates the shader on the fly
+        // constructor generates the shader on the fly, defines are added to every
+        // stage, see ShaderSource
         // ------------------------------------------------------------------------
-        Shader(const char *vertexPath, const char *fragmentPath, const char *geometryPath = nullptr)
+        Shader(const char *vertexPath, const char *fragmentPath, const char *geometryPath = nullptr,
+               const std::vector<std::string> &defines = {})
         {
             spdlog::info("Creating shader. [vertexShaderPath: {}, fragmentShaderPath: {}]", vertexPath, fragmentPath);
-            // 1. retrieve the vertex/fragment source code from filePath
-            std::string vertexCode;
-            std::string fragmentCode;
-            std::ifstream vShaderFile;
-            std::ifstream fShaderFile;
-
-            std::string geometryCode;
-            std::ifstream gShaderFile;
-
-            // ensure ifstream objects can throw exceptions:
-            vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-            fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-            gShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-            try
+            std::vector<Stage> stages = {
+                {GL_VERTEX_SHADER, ShaderSource::load(vertexPath, defines), "VERTEX"},
+                {GL_FRAGMENT_SHADER, ShaderSource::load(fragmentPath, defines), "FRAGMENT"}};
+            if (geometryPath != nullptr)
             {
-                // open files
-                vShaderFile.open(vertexPath);
-                fShaderFile.open(fragmentPath);
-                std::stringstream vShaderStream, fShaderStream;
-                // read file's buffer contents into streams
-                vShaderStream << vShaderFile.rdbuf();
-                fShaderStream << fShaderFile.rdbuf();
-                // close file handlers
-                vShaderFile.close();
-                fShaderFile.close();
-                // convert stream into string
-                vertexCode = vShaderStream.str();
-                fragmentCode = fShaderStream.str();
-
-                if(geometryPath != nullptr) {
-                    gShaderFile.open(geometryPath);
-                    std::stringstream gShaderStream;
-                    gShaderStream << gShaderFile.rdbuf();
-
-                    gShaderFile.close();
-                    geometryCode = gShaderStream.str();
-                }
-            }
-            catch (std::ifstream::failure &e)
-            {
-                spdlog::error("SHADER::FILE_NOT_SUCCESSFULLY_READ: {}", e.what());
-            }
-            const char *vShaderCode = vertexCode.c_str();
-            const char *fShaderCode = fragmentCode.c_str();
-            const char *gShaderCode = geometryCode.c_str();
-
-            // 2. compile shaders
-            unsigned int vertex, fragment, geometry;
-            // vertex shader
-            vertex = glCreateShader(GL_VERTEX_SHADER);
-            glShaderSource(vertex, 1, &vShaderCode, NULL);
-            glCompileShader(vertex);
-            checkCompileErrors(vertex, "VERTEX");
-            // fragment Shader
-            fragment = glCreateShader(GL_FRAGMENT_SHADER);
-            glShaderSource(fragment, 1, &fShaderCode, NULL);
-            glCompileShader(fragment);
-            checkCompileErrors(fragment, "FRAGMENT");
-
-            // shader Program
-            ID = glCreateProgram();
-            glAttachShader(ID, vertex);
-            glAttachShader(ID, fragment);
-
-            if(geometryPath != nullptr) {
                 spdlog::debug("\t\t\t \\\\+geometryShader: {}", geometryPath);
-                geometry = glCreateShader(GL_GEOMETRY_SHADER);
-                glShaderSource(geometry, 1, &gShaderCode, NULL);
-                glCompileShader(geometry);
-                checkCompileErrors(geometry, "GEOMETRY");
-                glAttachShader(ID, geometry);
+                stages.push_back({GL_GEOMETRY_SHADER, ShaderSource::load(geometryPath, defines), "GEOMETRY"});
             }
+            submit(stages);
+        }
 
-            glLinkProgram(ID);
-            checkCompileErrors(ID, "PROGRAM");
+        ~Shader() {
+            if (_pending != nullptr)
+                for (auto shader : _pending->shaders)
+                    glDeleteShader(shader);
+            spdlog::debug("Deallocation Shader");
+        }
 
-            // delete the shaders as they're linked into our program now and no longer necessary
-            glDeleteShader(vertex);
-            glDeleteShader(fragment);
-            spdlog::debug("Shader created successfully!");
+        // wraps an already linked program
+        explicit Shader(unsigned int program) : ID(program) {}
+
+        static sptr<Shader> create(const char *vertexPath, const char *fragmentPath, const char *geometryPath = nullptr,
+                                   const std::vector<std::string> &defines = {}){
+          return std::make_shared<Shader>(vertexPath, fragmentPath, geometryPath, defines);
         }
 
-      
+        // Compute program. Sources are concatenated in the given order after
+        // a "#version 430 core" line, so the files have no #version of their own.
+        static sptr<Shader> createCompute(const std::vector<std::string> &paths)
+        {
+            spdlog::info("Creating compute shader. [computeShaderPath: {}]", paths.back());
+            auto code = "#version 430 core\n" + readSources(paths);
+            auto shader = std::make_shared<Shader>(0u);
+            shader->submit({{GL_COMPUTE_SHADER, code, "COMPUTE"}});
+            return shader;
+        }
 
-        ~Shader() {
-            spdlog::debug("Deallocation Shader");
+        // Vertex-only program whose outputs are captured with transform feedback,
+        // interleaved in the order of varyings. Sources are concatenated after a
+        // "#version 330 core" line.
+        static sptr<Shader> createTransformFeedback(const std::vector<std::string> &paths,
+                                                    const std::vector<const char *> &varyings)
+        {
+            spdlog::info("Creating transform feedback shader. [vertexShaderPath: {}]", paths.back());
+            auto code = "#version 330 core\n" + readSources(paths);
+            auto shader = std::make_shared<Shader>(0u);
+            shader->submit({{GL_VERTEX_SHADER, code, "VERTEX"}}, varyings);
+            return shader;
+        }
+
+        // Program with tessellation stages, drawn as GL_PATCHES. Vertex, control and
+        // evaluation sources are concatenated after a "#version 400 core" line, the
+        // fragment shader is used as is, with the given defines.
+        static sptr<Shader> createTessellation(const std::vector<std::string> &vertexPaths,
+                                               const std::vector<std::string> &controlPaths,
+                                               const std::vector<std::string> &evaluationPaths,
+                                               const std::string &fragmentPath,
+                                               const std::vector<std::string> &fragmentDefines = {})
+        {
+            spdlog::info("Creating tessellation shader. [evaluationShaderPath: {}, fragmentShaderPath: {}]",
+                         evaluationPaths.back(), fragmentPath);
+            const std::string version = "#version 400 core\n";
+            auto shader = std::make_shared<Shader>(0u);
+            shader->submit({
+                {GL_VERTEX_SHADER, version + readSources(vertexPaths), "VERTEX"},
+                {GL_TESS_CONTROL_SHADER, version + readSources(controlPaths), "TESS_CONTROL"},
+                {GL_TESS_EVALUATION_SHADER, version + readSources(evaluationPaths), "TESS_EVALUATION"},
+                {GL_FRAGMENT_SHADER, ShaderSource::load(fragmentPath, fragmentDefines), "FRAGMENT"}});
+            return shader;
+        }
+
+        // Lets the driver compile on as many threads as it wants, so programs
+        // created one after another are built concurrently. Needs
+        // GL_KHR_parallel_shader_compile, a no-op otherwise.
+        static void enableParallelCompile()
+        {
+            if (GLAD_GL_KHR_parallel_shader_compile)
+                glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        }
+
+        // False while the driver is still compiling or linking. Without
+        // GL_KHR_parallel_shader_compile there is no way to ask, so it is
+        // always true and wait() blocks instead.
+        bool isReady() const
+        {
+            if (_pending == nullptr || !GLAD_GL_KHR_parallel_shader_compile)
+                return true;
+            GLint done;
+            glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+            return done;
+        }
+
+        // Blocks until the program is linked, checks it for errors and stores it
+        // in the ShaderCache. Called by use(), so only needed before touching ID
+        // directly.
+        void wait() const
+        {
+            if (_pending == nullptr)
+                return;
+            for (size_t i = 0; i < _pending->shaders.size(); i++)
+                checkCompileErrors(_pending->shaders[i], _pending->names[i]);
+            bool linked = checkCompileErrors(ID, "PROGRAM");
+
+            // delete the shaders as they're linked into our program now and no longer necessary
+            for (auto shader : _pending->shaders)
+                glDeleteShader(shader);
+            if (linked && _pending->cached)
+                ShaderCache::store(_pending->key, ID);
+            _pending.reset();
+            spdlog::debug("Shader created successfully!");
         }
 
-        static sptr<Shader> create(const char *vertexPath, const char *fragmentPath, const char *geometryPath = nullptr){
-          return std::make_shared<Shader>(vertexPath, fragmentPath, geometryPath);
+        bool isLinked() const
+        {
+            wait();
+            GLint success;
+            glGetProgramiv(ID, GL_LINK_STATUS, &success);
+            return success;
         }
 
         // activate the shader
         // ------------------------------------------------------------------------
         void use() const
         {
+            wait();
             glUseProgram(ID);
         }
         // utility uniform functions
@@ -180,9 +214,82 @@ namespace ENDER
         }
 
     private:
+        struct Stage
+        {
+            GLenum type;
+            std::string code;
+            const char *name;
+        };
+
+        // Compile and link submitted to the driver but not checked yet.
+        struct PendingLink
+        {
+            std::vector<unsigned int> shaders;
+            std::vector<const char *> names;
+            uint64_t key;
+            bool cached;
+        };
+        mutable uptr<PendingLink> _pending;
+
+        static std::string readSources(const std::vector<std::string> &paths)
+        {
+            std::string code;
+            for (auto &path : paths)
+                code += ShaderSource::load(path) + "\n";
+            return code;
+        }
+
+        static unsigned int compileStage(GLenum type, const std::string &code)
+        {
+            const char *source = code.c_str();
+            unsigned int shader = glCreateShader(type);
+            glShaderSource(shader, 1, &source, NULL);
+            glCompileShader(shader);
+            return shader;
+        }
+
+        // Loads the program from the ShaderCache when the same sources were
+        // linked before on this driver, otherwise starts compiling and linking
+        // them. Nothing is queried from the program here, so that the driver can
+        // build it in the background until wait().
+        void submit(const std::vector<Stage> &stages, const std::vector<const char *> &varyings = {})
+        {
+            uint64_t key = ShaderCache::driverHash();
+            for (auto &stage : stages)
+                key = ShaderCache::hash(std::to_string(stage.type) + "\n" + stage.code, key);
+            for (auto varying : varyings)
+                key = ShaderCache::hash(varying, key);
+
+            ID = ShaderCache::load(key);
+            if (ID != 0)
+            {
+                spdlog::debug("\t\t\t \\\\loaded from the shader cache");
+                return;
+            }
+
+            _pending = std::make_unique<PendingLink>();
+            _pending->key = key;
+            _pending->cached = ShaderCache::isEnabled();
+            for (auto &stage : stages)
+            {
+                _pending->shaders.push_back(compileStage(stage.type, stage.code));
+                _pending->names.push_back(stage.name);
+            }
+
+            ID = glCreateProgram();
+            for (auto shader : _pending->shaders)
+                glAttachShader(ID, shader);
+            if (!varyings.empty())
+                glTransformFeedbackVaryings(ID, varyings.size(), varyings.data(),
+                                            GL_INTERLEAVED_ATTRIBS);
+            if (_pending->cached)
+                glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            glLinkProgram(ID);
+        }
+
         // utility function for checking shader compilation/linking errors.
         // ------------------------------------------------------------------------
-        void checkCompileErrors(GLuint shader, std::string type)
+        static bool checkCompileErrors(GLuint shader, std::string type)
         {
             GLint success;
             GLchar infoLog[1024];
@@ -204,6 +311,7 @@ namespace ENDER
                     spdlog::error("SHADER::PROGRAM_LINKING_ERROR of type of type: {}\n{}", type, infoLog);
                 }
             }
+            return success;
         }
     };
 }
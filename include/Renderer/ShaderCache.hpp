@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ENDER
+{
+  // Disk cache of linked programs (glGetProgramBinary / glProgramBinary).
+  // Entries are keyed by a hash of everything that went into the link: the
+  // stage sources, with their #version and defines, and the GL vendor,
+  // renderer and version strings, so a driver update misses instead of
+  // loading a binary the driver would reject. A rejected binary is deleted
+  // and the caller compiles from source.
+  class ShaderCache
+  {
+    static std::string _directory;
+    static bool _enabled;
+    static unsigned int _hits;
+    static unsigned int _misses;
+
+    static std::string _path(uint64_t key);
+
+  public:
+    // Needs GL 4.1 and at least one binary format.
+    static bool isSupported();
+
+    static void setEnabled(bool enabled) { _enabled = enabled; }
+    static bool isEnabled() { return _enabled && isSupported(); }
+    static void setDirectory(const std::string &directory) { _directory = directory; }
+
+    // FNV-1a, stable across runs and platforms.
+    static uint64_t hash(const std::string &data, uint64_t seed = 0xcbf29ce484222325ull);
+    // Seed for program keys, a hash of the GL vendor, renderer and version.
+    static uint64_t driverHash();
+
+    // Returns a linked program created from the cached binary, 0 on a miss.
+    static unsigned int load(uint64_t key);
+    // Saves the binary of a linked program. The program should have been linked
+    // with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+    static void store(uint64_t key, unsigned int program);
+
+    // Deletes every cached binary.
+    static void clear();
+
+    static unsigned int hits() { return _hits; }
+    static unsigned int misses() { return _misses; }
+  };
+} // namespace ENDER
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace ENDER
+{
+  // Reads GLSL sources with two preprocessor extensions:
+  //  - #include "file", relative to the including file. Every file is pasted
+  //    once, later includes of it are skipped, so no include guards needed.
+  //    This happens before the GLSL preprocessor runs, so a file included
+  //    inside an #if block is missing from the other branches.
+  //  - defines, inserted as "#define NAME" right after the #version line (or
+  //    at the top when there is none), to build permutations of one source.
+  // #line directives keep compile errors pointing at the right line, the
+  // source string number is the index of the file in the order it was read.
+  class ShaderSource
+  {
+    static bool _append(std::string &code, const std::string &path,
+                        std::vector<std::string> &files);
+
+  public:
+    static std::string load(const std::string &path,
+                            const std::vector<std::string> &defines = {});
+  };
+} // namespace ENDER
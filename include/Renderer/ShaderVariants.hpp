@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Shader.hpp>
+#include <ender_types.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ENDER
+{
+  // Features of a shader permutation, each one is a define of the same name.
+  enum ShaderFeature : unsigned int
+  {
+    // Diffuse color from material.diffuse as a sampler2D at TexCoord.
+    Textured = 1 << 0,
+    // Unlit, material.ambient only.
+    Lines = 1 << 1,
+    // Writes object ids to the PickingTexture.
+    Picking = 1 << 2,
+    // Face normals from a geometry stage, for vertices without normals.
+    FlatNormals = 1 << 3,
+    // Per-instance offset at AttributeLocation::InstanceOffset.
+    Instanced = 1 << 4
+  };
+
+  // Permutations of one set of sources, each built on the first request for its
+  // combination of ShaderFeature flags and kept afterwards. The geometry stage,
+  // if any, is only attached to FlatNormals permutations.
+  class ShaderVariants
+  {
+    std::string _vertexPath;
+    std::string _fragmentPath;
+    std::string _geometryPath;
+    std::map<unsigned int, sptr<Shader>> _variants;
+
+  public:
+    ShaderVariants(const std::string &vertexPath, const std::string &fragmentPath,
+                   const std::string &geometryPath = "");
+
+    static sptr<ShaderVariants> create(const std::string &vertexPath,
+                                       const std::string &fragmentPath,
+                                       const std::string &geometryPath = "");
+
+    sptr<Shader> get(unsigned int features);
+    size_t count() const { return _variants.size(); }
+
+    static std::vector<std::string> defines(unsigned int features);
+  };
+} // namespace ENDER
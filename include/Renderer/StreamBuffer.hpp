@@ -0,0 +1,68 @@
+#pragma once
+
+#include <GpuMemory.hpp>
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+namespace ENDER
+{
+  // Uploads fill one region after another, the ones still read by the GPU
+  // are left alone.
+  const unsigned int STREAM_BUFFER_REGIONS = 3;
+  const unsigned int STREAM_BUFFER_ALIGNMENT = 256;
+  // Region size of the shared upload ring, see uploads().
+  const size_t STREAM_BUFFER_UPLOAD_REGION_SIZE = 1024 * 1024;
+
+  // Ring buffer for data that is re-uploaded often. Uploads are placed one
+  // after another in the current region, with GL_ARB_buffer_storage the
+  // storage is mapped once and an upload is a memcpy, otherwise it is a
+  // glBufferSubData, orphaning the storage if the next region is still busy.
+  // A region is reused only after the fence placed when it was left signals.
+  class StreamBuffer
+  {
+    unsigned int _id = 0;
+    // Bumped with every new buffer object, whose name may be a recycled one.
+    uint64_t _generation = 0;
+    unsigned int _target;
+    bool _persistent;
+    char *_mapped = nullptr;
+
+    size_t _minRegionSize;
+    size_t _regionSize = 0;
+    unsigned int _region = 0;
+    // Bytes of the current region taken by uploads.
+    size_t _head = 0;
+    GLsync _fences[STREAM_BUFFER_REGIONS] = {};
+
+    void _allocate(size_t regionSize);
+    void _release();
+    // Fences the current region and moves on to the next one.
+    void _nextRegion();
+    // Blocks until the GPU is done with the region, false if it is still busy
+    // and wait is not set.
+    bool _waitRegion(unsigned int region, bool wait);
+
+  public:
+    StreamBuffer(unsigned int target = GL_ARRAY_BUFFER,
+                 size_t minRegionSize = 0);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    // Copies the data to a part of the ring the GPU is not using and returns
+    // its offset in bytes. The data stays there until the ring comes around,
+    // it has to be drawn or copied elsewhere before. Storage is grown when the
+    // data does not fit into a region, which changes getIndex().
+    size_t write(const void *data, size_t size);
+
+    // Ring shared by buffers that stage full uploads through it, see
+    // BufferUsage::Stream.
+    static StreamBuffer &uploads();
+
+    unsigned int getIndex() const { return _id; }
+    uint64_t generation() const { return _generation; }
+    bool isPersistent() const { return _persistent; }
+    size_t capacity() const { return _regionSize * STREAM_BUFFER_REGIONS; }
+  };
+} // namespace ENDER
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+namespace ENDER
+{
+
+  // Buffer object exposed to shaders as a samplerBuffer, read there with
+  // texelFetch. internalFormat is a sized format, e.g. GL_RGBA32F.
+  class TextureBuffer
+  {
+    unsigned int _bufferId = 0;
+    unsigned int _textureId = 0;
+    unsigned int _internalFormat;
+    unsigned int _size = 0;
+
+  public:
+    TextureBuffer(unsigned int internalFormat);
+    ~TextureBuffer();
+
+    // Reallocates the storage only when the size changes.
+    void setData(const float *data, unsigned int size);
+
+    // Overwrites part of the storage, offset is in bytes.
+    void setSubData(unsigned int offset, const float *data, unsigned int size);
+
+    void bind(unsigned int unit) const;
+
+    unsigned int size() const { return _size; }
+    unsigned int getIndex() const { return _textureId; }
+  };
+} // namespace ENDER
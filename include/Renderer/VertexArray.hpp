@@ -1,7 +1,9 @@
 #pragma once
 
 #include "VertexBuffer.hpp"
+#include <GpuMemory.hpp>
 #include <IndexBuffer.hpp>
+#include <glm/glm.hpp>
 #include <spdlog/spdlog.h>
 #include <vector>
 namespace ENDER
@@ -12,7 +14,25 @@ namespace ENDER
     std::vector<uptr<VertexBuffer>> _vbos;
     uptr<IndexBuffer> _indexBuffer = nullptr;
 
+    struct BufferBinding {
+      // Attribute locations in the order of the layout.
+      std::vector<unsigned int> locations;
+      // Buffer generation the attributes were specified with. Growing buffers
+      // move to a new buffer object and are re-specified on bind.
+      uint64_t generation = 0;
+    };
+    mutable std::vector<BufferBinding> _bindings;
+
+    void _specifyAttributes(uint vboIndex) const;
+
+    // Next location for attributes without an explicit one.
     unsigned int _index = 0;
+    // Bit per enabled attribute location.
+    uint _attributeMask = 0;
+    uint _vertexCount = 0;
+    uint _patchVertices = 0;
+    glm::mat4 _positionTransform{1.0f};
+    uint64_t _version = 0;
 
   public:
     VertexArray();
@@ -21,6 +41,7 @@ namespace ENDER
     {
       if (_id > 0)
       {
+        GpuMemory::remove(GpuResourceKind::VertexArray, _id);
         glDeleteVertexArrays(1, &_id);
         spdlog::info("Deallocated VAO. Index: {}.", _id);
       }
@@ -32,14 +53,62 @@ namespace ENDER
 
     void setIndexBuffer(uptr<IndexBuffer> indexBuffer);
 
-    void setVBOdata(uint vboIndex, float *data, uint size);
+    void setVBOdata(uint vboIndex, const void *data, uint size);
+
+    void setVBOsubData(uint vboIndex, uint offset, const void *data, uint size);
+
+    void appendVBOdata(uint vboIndex, const void *data, uint size);
+
+    // Buffers are separate streams: each one can be re-uploaded with
+    // setVBOdata/setVBOsubData without touching the others. Returns the index
+    // of the buffer for those calls.
+    uint addVBO(uptr<VertexBuffer> vbo);
+
+    // Keeps the data in front, see VertexBuffer::resize.
+    void resizeVBO(uint vboIndex, uint size);
+
+    void setIndexSubData(uint first, const unsigned int *indices, uint count);
+
+    void resizeIndexBuffer(uint count);
+
+    // Changes made directly through these are not counted by version(), use
+    // the setters above.
+    VertexBuffer &getVBO(uint vboIndex) { return *_vbos.at(vboIndex); }
+    IndexBuffer &getIndexBuffer() { return *_indexBuffer; }
 
-    void addVBO(uptr<VertexBuffer> vbo);
+    // Bumped by everything that changes what the array draws.
+    uint64_t version() const { return _version; }
 
     bool isIndexBuffer() const;
 
+    bool hasAttribute(AttributeLocation location) const
+    {
+      return _attributeMask & (1u << static_cast<int>(location));
+    }
+
     unsigned int indexCount();
+    // Taken from the per-vertex buffers, instanced ones are not counted.
     uint verticesCount();
+    // Instances covered by the instanced buffers, 0 without them.
+    uint instancesCount();
+
+    // Vertex count of an array without buffers, whose vertices are generated
+    // in the shader from gl_VertexID.
+    void setVertexCount(uint count) { _vertexCount = count; _version++; }
+
+    // Vertices form patches of the given size and are drawn as GL_PATCHES,
+    // 0 for ordinary primitives.
+    void setPatchVertices(uint count) { _patchVertices = count; _version++; }
+    uint patchVertices() const { return _patchVertices; }
+
+    // Maps stored positions to model space, e.g. to expand quantized ones. The
+    // renderer applies it before the model matrix.
+    void setPositionTransform(const glm::mat4 &transform)
+    {
+      _positionTransform = transform;
+      _version++;
+    }
+    const glm::mat4 &getPositionTransform() const { return _positionTransform; }
 
     unsigned int getIndex() const
     {
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "BufferLayout.hpp"
+#include <GpuMemory.hpp>
+#include <StreamBuffer.hpp>
 #include <ender_types.hpp>
 
 namespace ENDER
@@ -8,15 +10,25 @@ namespace ENDER
   class VertexBuffer
   {
     unsigned int _id = 0;
+    // Bumped by _grow, the new buffer may get the name of the deleted one.
+    uint64_t _generation = 0;
     uptr<BufferLayout> _layout;
+    BufferUsage _usage;
     uint _count = 0;
+    // Bytes of data and bytes of allocated storage.
+    uint _size = 0;
+    uint _capacity = 0;
+
+    // Moves the data to a new buffer of the given capacity, changes _id.
+    void _grow(uint capacity);
 
   public:
-    VertexBuffer(uptr<BufferLayout> layout);
+    VertexBuffer(uptr<BufferLayout> layout, BufferUsage usage = BufferUsage::Dynamic);
     ~VertexBuffer()
     {
       if (_id > 0)
       {
+        GpuMemory::remove(GpuResourceKind::Buffer, _id);
         glDeleteBuffers(1, &_id);
         spdlog::info("Deallocated VBO. Index: {}.", _id);
       };
@@ -29,8 +41,30 @@ namespace ENDER
 
     BufferLayout &getLayout() const;
 
-    void setData(float *data, unsigned int size);
+    // Dynamic and stream buffers keep their storage while the data fits into
+    // it. Stream data is staged in StreamBuffer::uploads() and copied on the
+    // GPU.
+    void setData(const void *data, unsigned int size);
+
+    // Overwrites part of the already allocated storage, offset is in bytes.
+    // Sent directly for every usage.
+    void setSubData(unsigned int offset, const void *data, unsigned int size);
+
+    // Uploads only the new data after the existing one. Capacity grows
+    // geometrically, so appending a vertex at a time is amortized O(1).
+    void append(const void *data, unsigned int size);
+
+    // Changes the size keeping the data in front, new bytes are undefined.
+    // Growing moves the data to a new buffer.
+    void resize(unsigned int size);
 
     uint count() const { return _count; }
+    uint size() const { return _size; }
+    uint capacity() const { return _capacity; }
+    BufferUsage usage() const { return _usage; }
+
+    // Changes whenever the data moves to another buffer object, which a
+    // vertex array has to be pointed at even when the name is the same.
+    uint64_t generation() const { return _generation; }
   };
 } // namespace ENDER
@@ -8,6 +8,13 @@
 
 namespace ENDER
 {
+    // Frames drawn after an event when redrawing on demand, ImGui needs a few
+    // to settle hover states and layout.
+    const unsigned int REDRAW_FRAMES_AFTER_EVENT = 3;
+    // Longest wait for events when redrawing on demand, so that ImGui's text
+    // cursor still blinks.
+    const double REDRAW_WAIT_TIMEOUT = 0.5;
+
     class Window
     {
     public:
@@ -38,6 +45,11 @@ namespace ENDER
         double _deltaTime = 0;
         double _lastFrame = 0;
 
+        bool _redrawOnDemand = false;
+        unsigned int _redrawFrames = REDRAW_FRAMES_AFTER_EVENT;
+        // Keys and mouse buttons held down, e.g. while moving the camera.
+        int _heldInputs = 0;
+
         std::function<void(int, int)> _framebufferSizeCallback;
 
         std::unordered_map<int, mousePosCallback> _mousePosCallbacks;
@@ -60,6 +72,9 @@ namespace ENDER
         void _clickCursorCallback(GLFWwindow* window, int button, int action, int mods);
         void _inputCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
         void _scrollCallback(GLFWwindow *window, double offsetX, double offsetY);
+        void _focusCallback(GLFWwindow *window, int focused);
+        void _onEvent();
+        void _trackHeldInput(int action);
 
     public:
 
@@ -98,6 +113,22 @@ namespace ENDER
 
         static void pollEvents();
 
+        // When enabled, waitForRedraw() sleeps until there is something new to
+        // draw: an event, a requestRedraw() or input held down. Off by default,
+        // then every loop iteration draws a frame.
+        static void setRedrawOnDemand(bool value);
+        static bool isRedrawOnDemand();
+
+        // Asks for the next frames to be drawn when redrawing on demand, for
+        // changes that do not come from input: object and scene edits and
+        // surfaces marked dirty call it.
+        static void requestRedraw(unsigned int frames = 1);
+        static bool needsRedraw();
+
+        // Blocks until needsRedraw() when redrawing on demand, returns at once
+        // otherwise. The time spent waiting is left out of deltaTime().
+        static void waitForRedraw();
+
         static int getHeight();
 
         static int getWidth();
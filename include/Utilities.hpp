@@ -69,7 +69,7 @@ inline sptr<VertexArray> createParametricSurfaceVAO(ParametricSurfFunc func,
 
   auto layout = uptr<BufferLayout>(
       new ENDER::BufferLayout({{ENDER::LayoutObjectType::Float3}}));
-  auto vbo = std::make_unique<VertexBuffer>(std::move(layout));
+  auto vbo = std::make_unique<VertexBuffer>(std::move(layout), BufferUsage::Static);
   vbo->setData(vertices, sizeof(float) * rows * cols * 3);
 
   auto ibo =
@@ -1,13 +1,6 @@
-
-#version 330 core
-out vec4 FragColor;
-
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float shininess;
-};
+// Lights set by Renderer::_configureLight and _configureSpotLight, and Phong
+// shading of a material with them.
+#include "material.glsl"
 
 struct DirLight {
     bool enabled;
@@ -49,48 +42,14 @@ struct SpotLight {
 
 #define NR_POINT_LIGHTS 100
 
-in vec3 FragPos;
-in vec3 Normal;
-
 uniform vec3 viewPos;
 uniform DirLight dirLight;
 uniform PointLight pointLights[NR_POINT_LIGHTS];
 uniform SpotLight spotLight;
-uniform Material material;
 uniform int pointLightsCount;
-uniform bool selected;
-
-uniform mat4 projection;
-uniform mat4 model;
-
-// function prototypes
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-
-void main()
-{
-    vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
-
-
-    vec3 result = vec3(0.0);
-
-    if(dirLight.enabled)
-        result += CalcDirLight(dirLight, norm, viewDir);
-    // phase 2: point lights
-    for(int i = 0; i < pointLightsCount; i++)
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
-
-    if(spotLight.toggled)
-        result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
-    if(selected)
-        result *= vec3(0.3, 0.3, 0);
-    FragColor = vec4(result, 1.0);
-}
 
 // calculates the color when using a directional light.
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+vec3 CalcDirLight(DirLight light, Material material, vec3 normal, vec3 viewDir)
 {
     vec3 lightDir = normalize(-light.direction);
     // diffuse shading
@@ -106,7 +65,7 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
 }
 
 // calculates the color when using a point light.
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+vec3 CalcPointLight(PointLight light, Material material, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
     vec3 lightDir = normalize(light.position - fragPos);
     // diffuse shading
@@ -128,7 +87,7 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
 }
 
 // calculates the color when using a spot light.
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+vec3 CalcSpotLight(SpotLight light, Material material, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
     vec3 lightDir = normalize(light.position - fragPos);
     // diffuse shading
@@ -153,3 +112,17 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
     return (ambient + diffuse + specular);
 }
 
+// sums up the directional light, the point lights and the flashlight.
+vec3 CalcLighting(Material material, vec3 normal, vec3 fragPos)
+{
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 result = vec3(0.0);
+
+    if(dirLight.enabled)
+        result += CalcDirLight(dirLight, material, normal, viewDir);
+    for(int i = 0; i < pointLightsCount; i++)
+        result += CalcPointLight(pointLights[i], material, normal, fragPos, viewDir);
+    if(spotLight.toggled)
+        result += CalcSpotLight(spotLight, material, normal, fragPos, viewDir);
+    return result;
+}
@@ -0,0 +1,20 @@
+#version 430 core
+#include "include/lighting.glsl"
+
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+// Material of the draw, shininess and the selection flag in w.
+flat in vec4 Diffuse;
+flat in vec4 Ambient;
+flat in vec4 Specular;
+
+void main()
+{
+    Material material = Material(Ambient.rgb, Diffuse.rgb, Specular.rgb, Diffuse.w);
+    vec3 result = CalcLighting(material, normalize(Normal), FragPos);
+    if(Ambient.w > 0.5)
+        result *= vec3(0.3, 0.3, 0);
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,38 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+// Index of the draw, every command of the multi-draw starts its instance at it.
+layout (location = 3) in uint aDrawId;
+
+// MeshDrawData on the CPU side.
+struct DrawData {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 diffuse;
+    vec4 ambient;
+    vec4 specular;
+};
+
+layout (std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+flat out vec4 Diffuse;
+flat out vec4 Ambient;
+flat out vec4 Specular;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    DrawData draw = draws[aDrawId];
+    FragPos = vec3(draw.model * vec4(aPos, 1.0));
+    Normal = mat3(draw.normalMatrix) * aNormal;
+    Diffuse = draw.diffuse;
+    Ambient = draw.ambient;
+    Specular = draw.specular;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -8,7 +8,12 @@ out vec3 Normal;
 in vec3 fragPos[];
 out vec3 FragPos;
 
-uniform mat4 model;
+#ifdef TEXTURED
+in vec2 texCoords[];
+out vec2 TexCoords;
+#endif
+
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 
@@ -38,7 +43,10 @@ void main( void )
     {
         gl_Position = projection * view * vec4(fragPos[i], 1.0);
         FragPos = fragPos[i];
-        Normal =mat3(transpose(inverse(model)))*N;
+        Normal = normalMatrix * N;
+#ifdef TEXTURED
+        TexCoords = texCoords[i];
+#endif
         EmitVertex();
     }
 
@@ -0,0 +1,67 @@
+#version 330 core
+// Fragment shader of the renderer's objects, features are selected with
+// defines, see ShaderFeature.
+#include "include/material.glsl"
+
+#if defined(PICKING)
+
+uniform int gObjectIndex;
+uniform int gDrawIndex;
+
+out uvec3 FragColor;
+
+void main()
+{
+   FragColor = uvec3(gObjectIndex, gDrawIndex, gl_PrimitiveID);
+}
+
+#elif defined(LINES)
+
+out vec4 FragColor;
+
+uniform Material material;
+
+void main()
+{
+    FragColor = vec4(material.ambient, 1.0);
+}
+
+#else
+
+#include "include/lighting.glsl"
+
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+#ifdef TEXTURED
+in vec2 TexCoords;
+
+struct TexturedMaterial {
+    sampler2D diffuse;
+    vec3 specular;
+    float shininess;
+};
+
+uniform TexturedMaterial material;
+#else
+uniform Material material;
+#endif
+uniform bool selected;
+
+void main()
+{
+#ifdef TEXTURED
+    vec3 color = vec3(texture(material.diffuse, TexCoords));
+    Material surface = Material(color, color, material.specular, material.shininess);
+#else
+    Material surface = material;
+#endif
+    vec3 result = CalcLighting(surface, normalize(Normal), FragPos);
+    if(selected)
+        result *= vec3(0.3, 0.3, 0);
+    FragColor = vec4(result, 1.0);
+}
+
+#endif
@@ -0,0 +1,60 @@
+#version 330 core
+// Vertex shader of the renderer's objects, features are selected with defines,
+// see ShaderFeature.
+layout (location = 0) in vec3 aPos;
+#if !defined(LINES) && !defined(PICKING) && !defined(FLAT_NORMALS)
+#define LIT_VERTEX
+layout (location = 1) in vec3 aNormal;
+#endif
+#ifdef TEXTURED
+layout (location = 2) in vec2 aTexCoords;
+#endif
+#ifdef INSTANCED
+layout (location = 4) in vec3 aInstanceOffset;
+#endif
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat3 normalMatrix;
+
+#if defined(FLAT_NORMALS)
+// Passed on by normalsShader.gs, which computes the normals.
+out vec3 fragPos;
+#ifdef TEXTURED
+out vec2 texCoords;
+#endif
+#elif defined(LIT_VERTEX)
+out vec3 FragPos;
+out vec3 Normal;
+#ifdef TEXTURED
+out vec2 TexCoords;
+#endif
+#endif
+
+void main()
+{
+    vec3 position = aPos;
+#ifdef INSTANCED
+    position += aInstanceOffset;
+#endif
+    vec3 worldPos = vec3(model * vec4(position, 1.0));
+
+#if defined(FLAT_NORMALS)
+    fragPos = worldPos;
+#ifdef TEXTURED
+    texCoords = aTexCoords;
+#endif
+    // object space, the geometry stage projects
+    gl_Position = vec4(position, 1.0);
+#else
+#ifdef LIT_VERTEX
+    FragPos = worldPos;
+    Normal = normalMatrix * aNormal;
+#ifdef TEXTURED
+    TexCoords = aTexCoords;
+#endif
+#endif
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+#endif
+}
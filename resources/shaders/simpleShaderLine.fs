@@ -1,16 +0,0 @@
-#version 330 core
-out vec4 FragColor;
-
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float shininess;
-};
-
-uniform Material material;
-
-void main()
-{
-	FragColor = vec4(material.ambient, 1.0); 
-}
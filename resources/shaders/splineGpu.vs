@@ -0,0 +1,66 @@
+#version 330 core
+// Evaluates a (rational) B-spline at u = gl_VertexID / (samplesCount - 1).
+// Must match SPLINE_GPU_MAX_DEGREE.
+#define MAX_DEGREE 15
+
+// Control points as (position * weight, weight).
+uniform samplerBuffer controlPoints;
+uniform samplerBuffer knots;
+uniform int degree;
+uniform int pointsCount;
+uniform int samplesCount;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+float knot(int i)
+{
+	return texelFetch(knots, i).r;
+}
+
+int findSpan(float u)
+{
+	int n = pointsCount - 1;
+	if (u >= knot(n + 1))
+		return n;
+	int low = degree;
+	int high = n + 1;
+	int mid = (low + high) / 2;
+	while (u < knot(mid) || u >= knot(mid + 1)) {
+		if (u < knot(mid))
+			high = mid;
+		else
+			low = mid;
+		mid = (low + high) / 2;
+	}
+	return mid;
+}
+
+void main()
+{
+	float u = float(gl_VertexID) / float(samplesCount - 1);
+	int span = findSpan(u);
+
+	float N[MAX_DEGREE + 1];
+	float left[MAX_DEGREE + 1];
+	float right[MAX_DEGREE + 1];
+	N[0] = 1.0;
+	for (int j = 1; j <= degree; j++) {
+		left[j] = u - knot(span + 1 - j);
+		right[j] = knot(span + j) - u;
+		float saved = 0.0;
+		for (int r = 0; r < j; r++) {
+			float temp = N[r] / (right[r + 1] + left[j - r]);
+			N[r] = saved + right[r + 1] * temp;
+			saved = left[j - r] * temp;
+		}
+		N[j] = saved;
+	}
+
+	vec4 C = vec4(0.0);
+	for (int j = 0; j <= degree; j++)
+		C += N[j] * texelFetch(controlPoints, span - degree + j);
+
+	gl_Position = projection * view * model * vec4(C.xyz / C.w, 1.0f);
+}
@@ -0,0 +1,182 @@
+// Extrude, rotation and NURBS surfaces with analytic normals. Shared by
+// surfaceEval.comp, surfaceEvalFeedback.vs and the surfacePatch stages, has no
+// #version of its own.
+
+// Must match SPLINE_GPU_MAX_DEGREE.
+#define MAX_DEGREE 15
+
+// Must match GpuSurfaceType.
+#define SURFACE_EXTRUDE 0
+#define SURFACE_ROTATION 1
+#define SURFACE_NURBS 2
+
+// Control points as (position * weight, weight). Curve points for extrude
+// and rotation surfaces, the net (i * vCount + j) for NURBS surfaces.
+uniform samplerBuffer controlPoints;
+// u knots followed by v knots.
+uniform samplerBuffer knots;
+// Grid parameters: cols u values followed by rows v values.
+uniform samplerBuffer params;
+
+uniform int surfaceType;
+uniform int uDegree;
+uniform int vDegree;
+uniform int uCount;
+uniform int vCount;
+uniform int cols;
+uniform int rows;
+
+uniform vec3 extrudeVector;
+uniform float rotationRadius;
+
+float knot(int offset, int i)
+{
+    return texelFetch(knots, offset + i).r;
+}
+
+int findSpan(int offset, int n, int p, float u)
+{
+    if (u >= knot(offset, n + 1))
+        return n;
+    int low = p;
+    int high = n + 1;
+    int mid = (low + high) / 2;
+    while (u < knot(offset, mid) || u >= knot(offset, mid + 1)) {
+        if (u < knot(offset, mid))
+            high = mid;
+        else
+            low = mid;
+        mid = (low + high) / 2;
+    }
+    return mid;
+}
+
+// Nonzero basis functions of degree p at u and their first derivatives.
+void basisFuns(int offset, int span, float u, int p,
+               out float N[MAX_DEGREE + 1], out float dN[MAX_DEGREE + 1])
+{
+    float left[MAX_DEGREE + 1];
+    float right[MAX_DEGREE + 1];
+    // Basis of degree p - 1, the derivatives are built from it.
+    float lower[MAX_DEGREE + 1];
+
+    N[0] = 1.0;
+    lower[0] = 1.0;
+    for (int j = 1; j <= p; j++) {
+        left[j] = u - knot(offset, span + 1 - j);
+        right[j] = knot(offset, span + j) - u;
+        float saved = 0.0;
+        for (int r = 0; r < j; r++) {
+            float temp = N[r] / (right[r + 1] + left[j - r]);
+            N[r] = saved + right[r + 1] * temp;
+            saved = left[j - r] * temp;
+        }
+        N[j] = saved;
+        if (j == p - 1)
+            for (int r = 0; r <= j; r++)
+                lower[r] = N[r];
+    }
+
+    for (int j = 0; j <= p; j++) {
+        float d = 0.0;
+        if (j > 0) {
+            float span0 = knot(offset, span + j) - knot(offset, span + j - p);
+            if (span0 > 0.0)
+                d += lower[j - 1] / span0;
+        }
+        if (j < p) {
+            float span1 = knot(offset, span + j + 1) - knot(offset, span + j + 1 - p);
+            if (span1 > 0.0)
+                d -= lower[j] / span1;
+        }
+        dN[j] = float(p) * d;
+    }
+}
+
+void curvePoint(float u, out vec3 point, out vec3 derivative)
+{
+    int span = findSpan(0, uCount - 1, uDegree, u);
+    float N[MAX_DEGREE + 1];
+    float dN[MAX_DEGREE + 1];
+    basisFuns(0, span, u, uDegree, N, dN);
+
+    vec4 A = vec4(0.0);
+    vec4 dA = vec4(0.0);
+    for (int j = 0; j <= uDegree; j++) {
+        vec4 P = texelFetch(controlPoints, span - uDegree + j);
+        A += N[j] * P;
+        dA += dN[j] * P;
+    }
+    point = A.xyz / A.w;
+    derivative = (dA.xyz - dA.w * point) / A.w;
+}
+
+void nurbsPoint(float u, float v, out vec3 point, out vec3 du, out vec3 dv)
+{
+    int vOffset = uCount + uDegree + 1;
+    int uSpan = findSpan(0, uCount - 1, uDegree, u);
+    int vSpan = findSpan(vOffset, vCount - 1, vDegree, v);
+    float Nu[MAX_DEGREE + 1];
+    float dNu[MAX_DEGREE + 1];
+    float Nv[MAX_DEGREE + 1];
+    float dNv[MAX_DEGREE + 1];
+    basisFuns(0, uSpan, u, uDegree, Nu, dNu);
+    basisFuns(vOffset, vSpan, v, vDegree, Nv, dNv);
+
+    vec4 S = vec4(0.0);
+    vec4 Su = vec4(0.0);
+    vec4 Sv = vec4(0.0);
+    for (int l = 0; l <= vDegree; l++) {
+        vec4 row = vec4(0.0);
+        vec4 dRow = vec4(0.0);
+        for (int k = 0; k <= uDegree; k++) {
+            vec4 P = texelFetch(controlPoints,
+                                (uSpan - uDegree + k) * vCount + vSpan - vDegree + l);
+            row += Nu[k] * P;
+            dRow += dNu[k] * P;
+        }
+        S += Nv[l] * row;
+        Su += Nv[l] * dRow;
+        Sv += dNv[l] * row;
+    }
+    point = S.xyz / S.w;
+    du = (Su.xyz - Su.w * point) / S.w;
+    dv = (Sv.xyz - Sv.w * point) / S.w;
+}
+
+void surfacePoint(float u, float v, out vec3 position, out vec3 normal)
+{
+    vec3 du;
+    vec3 dv;
+    if (surfaceType == SURFACE_NURBS)
+        nurbsPoint(u, v, position, du, dv);
+    else {
+        vec3 c;
+        vec3 dc;
+        curvePoint(u, c, dc);
+        if (surfaceType == SURFACE_EXTRUDE) {
+            position = c + v * extrudeVector;
+            du = dc;
+            dv = extrudeVector;
+        } else {
+            float x = c.x - rotationRadius;
+            float cv = cos(v);
+            float sv = sin(v);
+            position = vec3(rotationRadius + x * cv, x * sv, c.z);
+            du = vec3(dc.x * cv, dc.x * sv, dc.z);
+            dv = vec3(-x * sv, x * cv, 0.0);
+        }
+    }
+
+    vec3 n = cross(du, dv);
+    float len = length(n);
+    normal = len > 1e-12 ? n / len : vec3(0.0, 0.0, 1.0);
+}
+
+// Vertex index runs along u inside a row, like in Surface::_tessellate.
+void surfaceVertex(int index, out vec3 position, out vec3 normal)
+{
+    float u = texelFetch(params, index % cols).r;
+    float v = texelFetch(params, cols + index / cols).r;
+    surfacePoint(u, v, position, normal);
+}
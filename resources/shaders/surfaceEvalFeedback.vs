@@ -0,0 +1,9 @@
+// Appended after surfaceEval.glsl. Fallback for contexts without compute
+// shaders: one point per vertex, captured with transform feedback.
+out vec3 outPosition;
+out vec3 outNormal;
+
+void main()
+{
+    surfaceVertex(gl_VertexID, outPosition, outNormal);
+}
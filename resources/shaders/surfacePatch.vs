@@ -0,0 +1,17 @@
+// Patch corners are (u, v) parameters. The surface is evaluated at them so
+// the control shader can measure the patch on screen.
+layout (location = 0) in vec2 aParam;
+
+uniform mat4 model;
+
+out vec2 vParam;
+out vec3 vWorldPos;
+
+void main()
+{
+    vec3 position;
+    vec3 normal;
+    surfacePoint(aParam.x, aParam.y, position, normal);
+    vParam = aParam;
+    vWorldPos = vec3(model * vec4(position, 1.0));
+}
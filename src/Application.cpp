@@ -44,6 +44,7 @@ void Application::start(){
   _isRunning = true;
   onStart();
   while(_isRunning && !Window::windowShouldClose()){
+    Window::waitForRedraw();
     update(Window::deltaTime());
     _render();
   }
@@ -13,6 +13,7 @@ ExtrudeSurface::ExtrudeSurface(const std::string &name,
                                const glm::vec3 &direction, float extrudeLength)
     : Surface(name), _baseSpline(baseSpline), _direction(direction),
       _length(extrudeLength) {
+  _addDependency(_baseSpline, true);
   update();
 }
 
@@ -24,20 +25,41 @@ sptr<ExtrudeSurface> ExtrudeSurface::create(const std::string &name,
       new ExtrudeSurface(name, baseSpline, direction, extrudeLength));
 }
 
-void ExtrudeSurface::update() {
-  auto vao = ENDER::Utils::createParametricSurfaceVAO(
-      [&](float u, float v) { return pointOnSurface(u, v); }, 0, 0, 1, 1,
-      SURFACE_ROWS, SURFACE_COLS);
-  setVertexArray(vao);
-}
+void ExtrudeSurface::update() { invalidate(); }
 
 glm::vec3 ExtrudeSurface::pointOnSurface(float u, float v) {
   auto direction = _direction / glm::length(_direction);
   return _baseSpline->getSplinePoint(u) + v * _length * direction;
 }
 
+void ExtrudeSurface::_evaluateGrid(SurfaceLod &lod, uint rowFirst,
+                                   uint rowLast, uint colFirst,
+                                   uint colLast) {
+  // Point and tangent of the curve per column of the block.
+  auto curve =
+      _baseSpline->evaluateBatch(_paramRange(lod.us, colFirst, colLast), 1);
+  auto extrude = _direction / glm::length(_direction) * _length;
+  for (uint i = rowFirst; i < rowLast; i++) {
+    auto shift = lod.vs[i] * extrude;
+    for (uint j = colFirst; j < colLast; j++) {
+      auto k = (j - colFirst) * 2;
+      _setVertex(lod, i, j, curve[k] + shift, curve[k + 1], extrude);
+    }
+  }
+}
+
+bool ExtrudeSurface::_getGpuSurface(GpuSurface &surface) {
+  if (!_baseSpline->getBSplineForm(surface.uDegree, surface.knots,
+                                   surface.controlPoints))
+    return false;
+  surface.type = GpuSurfaceType::Extrude;
+  surface.extrudeVector = _direction / glm::length(_direction) * _length;
+  surface.uCount = surface.controlPoints.size();
+  return true;
+}
+
 void ExtrudeSurface::drawProperties() {
-  ENDER::Object::drawProperties();
+  Surface::drawProperties();
   bool shouldUpdate = false;
   if (ImGui::TreeNode("Extrude Surface")) {
     shouldUpdate = ImGui::DragFloat3("Extrude Direction",
@@ -47,7 +69,7 @@ void ExtrudeSurface::drawProperties() {
     ImGui::TreePop();
   }
   if (shouldUpdate)
-    update();
+    markDirty();
 }
 
 void ExtrudeSurface::drawGizmo() {
@@ -0,0 +1,232 @@
+#include <GpuSurfaceEvaluator.hpp>
+
+namespace EGEOM {
+
+// Must match local_size_x of surfaceEval.comp.
+static const uint COMPUTE_GROUP_SIZE = 64;
+
+void GpuSurfaceEvaluator::_init(Backend preferred) {
+  _initialized = true;
+  _backend = Backend::None;
+  _program = nullptr;
+
+  if (preferred == Backend::Compute && GLAD_GL_VERSION_4_3) {
+    _program = ENDER::Shader::createCompute(
+        {"../resources/shaders/surfaceEval.glsl",
+         "../resources/shaders/surfaceEval.comp"});
+    if (_program->isLinked())
+      _backend = Backend::Compute;
+    else
+      preferred = Backend::TransformFeedback;
+  } else if (preferred == Backend::Compute)
+    preferred = Backend::TransformFeedback;
+
+  if (preferred == Backend::TransformFeedback) {
+    _program = ENDER::Shader::createTransformFeedback(
+        {"../resources/shaders/surfaceEval.glsl",
+         "../resources/shaders/surfaceEvalFeedback.vs"},
+        {"outPosition", "outNormal"});
+    if (_program->isLinked())
+      _backend = Backend::TransformFeedback;
+  }
+
+  if (_backend == Backend::None) {
+    spdlog::warn("GpuSurfaceEvaluator: no usable backend, surfaces are "
+                 "tessellated on the CPU");
+    return;
+  }
+
+  if (_controlPoints == nullptr) {
+    ENDER::GpuMemory::OwnerScope owner("GpuSurfaceEvaluator");
+    _controlPoints = std::make_unique<ENDER::TextureBuffer>(GL_RGBA32F);
+    _knots = std::make_unique<ENDER::TextureBuffer>(GL_R32F);
+    _params = std::make_unique<ENDER::TextureBuffer>(GL_R32F);
+    _emptyVertexArray = std::make_shared<ENDER::VertexArray>();
+  }
+  spdlog::info("GpuSurfaceEvaluator: using {} backend",
+               _backend == Backend::Compute ? "compute" : "transform feedback");
+}
+
+GpuSurfaceEvaluator::Backend GpuSurfaceEvaluator::getBackend() {
+  auto &evaluator = instance();
+  if (!evaluator._initialized)
+    evaluator._init(Backend::Compute);
+  return evaluator._backend;
+}
+
+void GpuSurfaceEvaluator::setBackend(Backend backend) {
+  instance()._init(backend);
+}
+
+void GpuSurfaceEvaluator::setSurfaceUniforms(ENDER::Shader &program,
+                                             const GpuSurface &surface) {
+  program.setInt("controlPoints", 0);
+  program.setInt("knots", 1);
+  program.setInt("surfaceType", static_cast<int>(surface.type));
+  program.setInt("uDegree", surface.uDegree);
+  program.setInt("vDegree", surface.vDegree);
+  program.setInt("uCount", surface.uCount);
+  program.setInt("vCount", surface.vCount);
+  program.setVec3("extrudeVector", surface.extrudeVector);
+  program.setFloat("rotationRadius", surface.rotationRadius);
+}
+
+bool GpuSurfaceEvaluator::evaluate(const GpuSurface &surface,
+                                   const std::vector<float> &us,
+                                   const std::vector<float> &vs,
+                                   ENDER::VertexBuffer &vbo) {
+  auto backend = getBackend();
+  if (backend == Backend::None)
+    return false;
+  auto &evaluator = instance();
+  auto &program = *evaluator._program;
+
+  uint count = us.size() * vs.size();
+  vbo.setData(nullptr, count * 6 * sizeof(float));
+
+  evaluator._paramsData.assign(us.begin(), us.end());
+  evaluator._paramsData.insert(evaluator._paramsData.end(), vs.begin(),
+                               vs.end());
+  evaluator._controlPoints->setData(
+      glm::value_ptr(surface.controlPoints[0]),
+      surface.controlPoints.size() * sizeof(glm::vec4));
+  evaluator._knots->setData(surface.knots.data(),
+                            surface.knots.size() * sizeof(float));
+  evaluator._params->setData(evaluator._paramsData.data(),
+                             evaluator._paramsData.size() * sizeof(float));
+
+  program.use();
+  evaluator._controlPoints->bind(0);
+  evaluator._knots->bind(1);
+  evaluator._params->bind(2);
+  program.setInt("params", 2);
+  setSurfaceUniforms(program, surface);
+  program.setInt("cols", us.size());
+  program.setInt("rows", vs.size());
+
+  if (backend == Backend::Compute) {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vbo.getIndex());
+    glDispatchCompute((count + COMPUTE_GROUP_SIZE - 1) / COMPUTE_GROUP_SIZE, 1,
+                      1);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    // Results are read back as vertex attributes.
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+  } else {
+    evaluator._emptyVertexArray->bind();
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, vbo.getIndex());
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, count);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+    evaluator._emptyVertexArray->unbind();
+  }
+  return true;
+}
+
+sptr<ENDER::Shader> GpuSurfaceEvaluator::getPatchShader(bool picking) {
+  auto &evaluator = instance();
+  if (!evaluator._patchShadersCreated) {
+    evaluator._patchShadersCreated = true;
+    if (!GLAD_GL_VERSION_4_0) {
+      spdlog::warn("GpuSurfaceEvaluator: no tessellation stages, surfaces "
+                   "can not be drawn as patches");
+      return nullptr;
+    }
+    auto create = [](const std::vector<std::string> &fragmentDefines) {
+      const std::string eval = "../resources/shaders/surfaceEval.glsl";
+      auto shader = ENDER::Shader::createTessellation(
+          {eval, "../resources/shaders/surfacePatch.vs"},
+          {eval, "../resources/shaders/surfacePatch.tcs"},
+          {eval, "../resources/shaders/surfacePatch.tes"},
+          "../resources/shaders/object.fs", fragmentDefines);
+      return shader->isLinked() ? shader : nullptr;
+    };
+    evaluator._patchShader = create({});
+    evaluator._patchPickingShader = create({"PICKING"});
+  }
+  return picking ? evaluator._patchPickingShader : evaluator._patchShader;
+}
+
+// Distinct knots inside range, including both of its ends.
+static std::vector<float> patchBreaks(const float *knots, uint count,
+                                      const glm::vec2 &range) {
+  std::vector<float> breaks = {range.x};
+  for (uint i = 0; i < count; i++)
+    if (knots[i] > breaks.back() && knots[i] < range.y)
+      breaks.push_back(knots[i]);
+  breaks.push_back(range.y);
+  return breaks;
+}
+
+void GpuSurfacePatches::upload(const GpuSurface &surface,
+                               const glm::vec2 &uRange,
+                               const glm::vec2 &vRange) {
+  _surface = surface;
+  // Vectors are only needed once, the buffers keep them.
+  _surface.knots.clear();
+  _surface.controlPoints.clear();
+
+  if (_controlPoints == nullptr) {
+    _controlPoints = std::make_unique<ENDER::TextureBuffer>(GL_RGBA32F);
+    _knots = std::make_unique<ENDER::TextureBuffer>(GL_R32F);
+  }
+  _controlPoints->setData(glm::value_ptr(surface.controlPoints[0]),
+                          surface.controlPoints.size() * sizeof(glm::vec4));
+  _knots->setData(surface.knots.data(), surface.knots.size() * sizeof(float));
+
+  uint uKnots = surface.uCount + surface.uDegree + 1;
+  auto us = patchBreaks(surface.knots.data(), uKnots, uRange);
+  std::vector<float> vs;
+  switch (surface.type) {
+  case GpuSurfaceType::Nurbs:
+    vs = patchBreaks(surface.knots.data() + uKnots,
+                     surface.knots.size() - uKnots, vRange);
+    break;
+  case GpuSurfaceType::Rotation: {
+    // Quarter turns at most, a single patch can only get MAX_LEVEL segments.
+    float quarter = glm::pi<float>() * 0.5f;
+    uint count =
+        std::max(1u, uint(std::ceil((vRange.y - vRange.x) / quarter)));
+    for (uint i = 0; i <= count; i++)
+      vs.push_back(glm::mix(vRange.x, vRange.y, float(i) / count));
+    break;
+  }
+  default:
+    vs = {vRange.x, vRange.y};
+  }
+
+  auto cornersCount = _corners.size();
+  _corners.clear();
+  for (uint i = 0; i + 1 < vs.size(); i++)
+    for (uint j = 0; j + 1 < us.size(); j++)
+      _corners.insert(_corners.end(), {us[j], vs[i], us[j + 1], vs[i],
+                                       us[j + 1], vs[i + 1], us[j], vs[i + 1]});
+
+  if (_vertexArray != nullptr && cornersCount == _corners.size()) {
+    _vertexArray->setVBOdata(0, _corners.data(),
+                             _corners.size() * sizeof(float));
+    return;
+  }
+
+  auto layout = uptr<ENDER::BufferLayout>(
+      new ENDER::BufferLayout({{ENDER::LayoutObjectType::Float2}}));
+  auto vbo = std::make_unique<ENDER::VertexBuffer>(std::move(layout));
+  vbo->setData(_corners.data(), _corners.size() * sizeof(float));
+  _vertexArray = std::make_shared<ENDER::VertexArray>();
+  _vertexArray->addVBO(std::move(vbo));
+  _vertexArray->setPatchVertices(4);
+}
+
+void GpuSurfacePatches::bind(ENDER::Shader &shader,
+                             const glm::vec2 &viewportSize,
+                             float pixelsPerSegment) const {
+  _controlPoints->bind(0);
+  _knots->bind(1);
+  GpuSurfaceEvaluator::setSurfaceUniforms(shader, _surface);
+  shader.setVec2("viewportSize", viewportSize);
+  shader.setFloat("pixelsPerSegment", pixelsPerSegment);
+}
+
+} // namespace EGEOM
@@ -8,6 +8,8 @@ KinematicSurface::KinematicSurface(const std::string &name,
                                    const KinematicSurfaceType &type)
     : Surface(name), _formingSpline(formingSpline), _guideSpline(guideSpline),
       _type(type) {
+  _addDependency(_formingSpline, true);
+  _addDependency(_guideSpline, false);
   update();
 }
 sptr<KinematicSurface>
@@ -19,10 +21,6 @@ KinematicSurface::create(const std::string &name,
       new KinematicSurface(name, formingSpline, guideSpline, type));
 }
 
-glm::vec3 KinematicSurface::sweepSplineHelper(float v) {
-  return glm::vec3{v + 1000 * v * v, v - 1000 * v, v * v + 1000};
-}
-
 glm::vec3 KinematicSurface::pointOnSurface(float u, float v) {
   switch (_type) {
   case KinematicSurfaceType::Shift: {
@@ -34,22 +32,13 @@ glm::vec3 KinematicSurface::pointOnSurface(float u, float v) {
     return p;
   } break;
   case KinematicSurfaceType::Sweep: {
-    auto gs = _guideSpline->getSplineDirs(v, 2);
-    glm::vec3 d = gs[0]->getPosition() - sweepSplineHelper(v);
-    // glm::vec3 d = glm::normalize(
-    //     glm::cross(gs[1]->getPosition(), gs[2]->getPosition()));
-    auto i1 = glm::normalize(gs[1]->getPosition());
-    auto d2 = d - (glm::dot(i1, d)) * i1;
-    auto i2 = glm::normalize(d2);
-    auto i3 = glm::cross(i1, i2);
-
-    glm::mat3 A{i1, i2, i3};
-    auto M = A * Am;
+    auto frame = _guideSpline->getRotationMinimizingFrame(v);
+    auto M = frame.basis() * Am;
     // // spdlog::info("M[][0] = {} {} {}", M[0][0], M[1][0], M[2][0]);
     // // spdlog::info("M[][1] = {} {} {}", M[0][1], M[1][1], M[2][1]);
     // // spdlog::info("M[][2] = {} {} {}", M[0][2], M[1][2], M[2][2]);
     auto gp0 = g0[0]->getPosition();
-    auto g = gs[0]->getPosition();
+    auto g = frame.point;
     auto c = _formingSpline->getSplinePoint(u);
     glm::vec3 h = {0, 0, 0};
     auto p = g + M * (c - gp0 - h);
@@ -58,33 +47,111 @@ glm::vec3 KinematicSurface::pointOnSurface(float u, float v) {
   }
 };
 
+void KinematicSurface::_evaluateGrid(SurfaceLod &lod, uint rowFirst,
+                                     uint rowLast, uint colFirst,
+                                     uint colLast) {
+  // Point and tangent per column and row of the block.
+  auto forming =
+      _formingSpline->evaluateBatch(_paramRange(lod.us, colFirst, colLast), 1);
+  auto rows = _paramRange(lod.vs, rowFirst, rowLast);
+  auto gp0 = g0[0]->getPosition();
+
+  if (_type == KinematicSurfaceType::Shift) {
+    auto guide = _guideSpline->evaluateBatch(rows, 1);
+    for (uint i = rowFirst; i < rowLast; i++) {
+      auto g = (i - rowFirst) * 2;
+      for (uint j = colFirst; j < colLast; j++) {
+        auto f = (j - colFirst) * 2;
+        _setVertex(lod, i, j, guide[g] + (forming[f] - gp0), forming[f + 1],
+                   guide[g + 1]);
+      }
+    }
+    return;
+  }
+
+  // Sweep: the frame depends on v only, the forming curve on u only.
+  auto arena = &ENDER::FrameArena::local();
+  auto guide = _guideSpline->getRotationMinimizingFrames(rows);
+  // Point, first and second derivative of the guide.
+  auto guideDers = _guideSpline->evaluateBatch(rows, 2);
+
+  std::pmr::vector<glm::mat3> frames(arena);
+  std::pmr::vector<glm::mat3> frameDers(arena);
+  frames.reserve(rowLast - rowFirst);
+  frameDers.reserve(rowLast - rowFirst);
+  for (uint i = rowFirst; i < rowLast; i++) {
+    auto &frame = guide[i - rowFirst];
+    frames.push_back(frame.basis() * Am);
+
+    // The tangent turns with the curvature, the other two axes of a rotation
+    // minimizing frame only follow it: r' = -(r . t') t.
+    auto d1 = guideDers[(i - rowFirst) * 3 + 1];
+    auto d2 = guideDers[(i - rowFirst) * 3 + 2];
+    float speed = glm::length(d1);
+    auto dt = speed > 1e-6f
+                  ? (d2 - glm::dot(d2, frame.tangent) * frame.tangent) / speed
+                  : glm::vec3{0.0f};
+    auto dNormal = -glm::dot(frame.normal, dt) * frame.tangent;
+    auto dBinormal = -glm::dot(frame.binormal, dt) * frame.tangent;
+    frameDers.push_back(glm::mat3{dt, dNormal, dBinormal} * Am);
+  }
+
+  std::pmr::vector<glm::vec3> local(arena);
+  local.reserve(colLast - colFirst);
+  for (uint j = colFirst; j < colLast; j++)
+    local.push_back(forming[(j - colFirst) * 2] - gp0);
+
+  for (uint i = rowFirst; i < rowLast; i++) {
+    auto &M = frames[i - rowFirst];
+    auto &dM = frameDers[i - rowFirst];
+    auto &g = guide[i - rowFirst].point;
+    auto &dg = guideDers[(i - rowFirst) * 3 + 1];
+    for (uint j = colFirst; j < colLast; j++) {
+      auto &c = local[j - colFirst];
+      _setVertex(lod, i, j, g + M * c, M * forming[(j - colFirst) * 2 + 1],
+                 dg + dM * c);
+    }
+  }
+}
+
 void KinematicSurface::drawProperties() {
   std::vector<const char *> items = {"Sweep", "Shift"};
   int currentKinematicSurfaceType = static_cast<int>(_type);
 
+  Surface::drawProperties();
+
   if (ImGui::TreeNode("Kinematic Surface")) {
     if (ImGui::Combo("Kinematic Surface Type", &currentKinematicSurfaceType,
                      &items[0], items.size())) {
       _type = static_cast<KinematicSurfaceType>(currentKinematicSurfaceType);
-      update();
+      markDirty();
     }
     ImGui::TreePop();
   }
 }
 void KinematicSurface::drawGizmo() {}
 
+void KinematicSurface::_onDependencyChanged(bool alongU, float from,
+                                            float to) {
+  if (alongU) {
+    Surface::_onDependencyChanged(alongU, from, to);
+    return;
+  }
+  // Start frame of the guide is baked into g0 and Am.
+  if (from <= 0.0f)
+    markDirty();
+  // Rotation minimizing frames are transported along v, a change at from
+  // turns the frames of every later row as well.
+  else if (_type == KinematicSurfaceType::Sweep)
+    Surface::_onDependencyChanged(alongU, from, _vMax);
+  else
+    Surface::_onDependencyChanged(alongU, from, to);
+}
+
 void KinematicSurface::update() {
   g0 = _guideSpline->getSplineDirs(0, 3);
-  glm::vec3 d = g0[0]->getPosition() - sweepSplineHelper(0);
-  auto i10 = glm::normalize(g0[1]->getPosition());
-  auto d20 = d - (glm::dot(i10, d)) * i10;
-  auto i20 = glm::normalize(d20);
-  auto i30 = glm::cross(i10, i20);
-  glm::mat3 AAm{i10, i20, i30};
-  Am = glm::inverse(AAm);
-  auto vao = ENDER::Utils::createParametricSurfaceVAO(
-      [&](float u, float v) { return pointOnSurface(u, v); }, 0, 0, 1, 1,
-      SURFACE_ROWS, SURFACE_COLS);
-  setVertexArray(vao);
+  // Frames are orthonormal, the inverse is the transpose.
+  Am = glm::transpose(_guideSpline->getRotationMinimizingFrame(0).basis());
+  invalidate();
 }
 } // namespace EGEOM
@@ -5,6 +5,7 @@ namespace EGEOM {
 Line::Line(std::vector<sptr<Point>> points)
     : ENDER::Object("Line"), _points{points} {
   type = ObjectType::Line;
+  ENDER::GpuMemory::OwnerScope owner(_name);
 
   auto layout = uptr<ENDER::BufferLayout>(
       new ENDER::BufferLayout({{ENDER::LayoutObjectType::Float3}}));
@@ -22,11 +23,12 @@ Line::Line(std::vector<sptr<Point>> points)
 void Line::addPoint(sptr<Point> point) {
   
   _points.push_back(point);
-  _rawData.insert(
-      _rawData.end(),
-      {point->getPosition().x, point->getPosition().y, point->getPosition().z});
+  float position[] = {point->getPosition().x, point->getPosition().y,
+                      point->getPosition().z};
+  _rawData.insert(_rawData.end(), std::begin(position), std::end(position));
 
-  _vertexArray->setVBOdata(0, &_rawData[0], _rawData.size()*sizeof(float));
+  // Only the new vertex is uploaded.
+  _vertexArray->appendVBOdata(0, position, sizeof(position));
 }
 
 } // namespace EGEOM
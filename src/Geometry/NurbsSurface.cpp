@@ -0,0 +1,219 @@
+#include "FrameArena.hpp"
+#include "glm/gtc/type_ptr.hpp"
+#include "imgui.h"
+#include "spdlog/spdlog.h"
+#include <NurbsSurface.hpp>
+#include <string>
+
+namespace EGEOM {
+
+static void checkDirection(const char *direction, uint count, int &degree,
+                           std::vector<float> &knots) {
+  if (count < degree + 1) {
+    spdlog::warn("NurbsSurface: not enough control points along {} (len = "
+                 "{}) for degree {}. Changing degree to len-1.",
+                 direction, count, degree);
+    degree = count - 1;
+  }
+  if (knots.size() != count + degree + 1) {
+    spdlog::warn("NurbsSurface: knot vector along {} should have "
+                 "count+degree+1 elements. Initializing with default one.",
+                 direction);
+    knots = std::vector<float>(count + degree + 1, 0);
+    for (auto i = 0; i < degree + 1; i++)
+      knots[knots.size() - i - 1] = 1;
+    float step = 1.0f / (count - degree);
+    for (auto i = degree + 1; i < knots.size() - degree - 1; i++)
+      knots[i] = (i - degree) * step;
+  }
+}
+
+NurbsSurface::NurbsSurface(const std::string &name,
+                           const std::vector<glm::vec3> &controlPoints,
+                           uint uCount, uint vCount, int uDegree, int vDegree,
+                           const std::vector<float> &uKnots,
+                           const std::vector<float> &vKnots,
+                           const std::vector<float> &weights)
+    : Surface(name), _controlPoints(controlPoints), _weights(weights),
+      _uCount(uCount), _vCount(vCount), _uDegree(uDegree), _vDegree(vDegree),
+      _uKnots(uKnots), _vKnots(vKnots) {
+  if (uCount < 2 || vCount < 2 || _controlPoints.size() != uCount * vCount) {
+    spdlog::error("NurbsSurface: control net should have uCount * vCount "
+                  "points, uCount, vCount >= 2 (got {} points, {}x{})",
+                  _controlPoints.size(), uCount, vCount);
+    throw;
+  }
+  update();
+}
+
+sptr<NurbsSurface> NurbsSurface::create(
+    const std::string &name, const std::vector<glm::vec3> &controlPoints,
+    uint uCount, uint vCount, int uDegree, int vDegree,
+    const std::vector<float> &uKnots, const std::vector<float> &vKnots,
+    const std::vector<float> &weights) {
+  return sptr<NurbsSurface>(new NurbsSurface(name, controlPoints, uCount,
+                                             vCount, uDegree, vDegree, uKnots,
+                                             vKnots, weights));
+}
+
+void NurbsSurface::_checkAndSetDefault() {
+  _uDegree = std::max(_uDegree, 1);
+  _vDegree = std::max(_vDegree, 1);
+  checkDirection("u", _uCount, _uDegree, _uKnots);
+  checkDirection("v", _vCount, _vDegree, _vKnots);
+  if (_weights.size() != _controlPoints.size()) {
+    spdlog::warn("NurbsSurface: Weights count not equal to control points "
+                 "count. Initializing with default one");
+    _weights = std::vector<float>(_controlPoints.size(), 1);
+  }
+}
+
+void NurbsSurface::update() {
+  _checkAndSetDefault();
+  _knotVersion++;
+  _uBasisTables.clear();
+  _vBasisTables.clear();
+
+  _uMin = _uKnots[_uDegree];
+  _uMax = _uKnots[_uCount];
+  _vMin = _vKnots[_vDegree];
+  _vMax = _vKnots[_vCount];
+
+  _net.resize(_controlPoints.size());
+  for (auto k = 0; k < _controlPoints.size(); k++)
+    _net[k] = glm::vec4{_controlPoints[k] * _weights[k], _weights[k]};
+
+  invalidate();
+}
+
+void NurbsSurface::setControlPoint(uint i, uint j, const glm::vec3 &position,
+                                   float weight) {
+  auto index = i * _vCount + j;
+  _controlPoints[index] = position;
+  _weights[index] = weight;
+  _net[index] = glm::vec4{position * weight, weight};
+  _markRegionDirty(true, _uKnots[i], _uKnots[i + _uDegree + 1]);
+}
+
+glm::vec3 NurbsSurface::pointOnSurface(float u, float v) {
+  int uSpan = bSplineFindSpan(_uCount - 1, _uDegree, u, _uKnots);
+  int vSpan = bSplineFindSpan(_vCount - 1, _vDegree, v, _vKnots);
+  auto Nu = bSplineBasisFunc(uSpan, u, _uDegree, _uKnots);
+  auto Nv = bSplineBasisFunc(vSpan, v, _vDegree, _vKnots);
+
+  glm::vec4 S{0.0f};
+  for (auto l = 0; l <= _vDegree; l++) {
+    glm::vec4 temp{0.0f};
+    int column = vSpan - _vDegree + l;
+    for (auto k = 0; k <= _uDegree; k++)
+      temp += Nu[k] * _net[(uSpan - _uDegree + k) * _vCount + column];
+    S += Nv[l] * temp;
+  }
+  return glm::vec3(S) / S.w;
+}
+
+void NurbsSurface::_evaluateGrid(SurfaceLod &lod, uint rowFirst,
+                                 uint rowLast, uint colFirst, uint colLast) {
+  auto &uTable = _uBasisTables.get(_knotVersion, _uDegree, 1, lod.us,
+                                   _uCount - 1, _uKnots);
+  auto &vTable = _vBasisTables.get(_knotVersion, _vDegree, 1, lod.vs,
+                                   _vCount - 1, _vKnots);
+
+  // First pass: one curve in v per grid column, its control points are the
+  // net rows blended with the u-basis of that column. The same rows blended
+  // with the u-derivatives give the curve of the partial derivative in u.
+  auto size = (colLast - colFirst) * _vCount;
+  std::pmr::vector<glm::vec4> columns(size, glm::vec4(0.0f),
+                                      &ENDER::FrameArena::local());
+  std::pmr::vector<glm::vec4> dColumns(size, glm::vec4(0.0f),
+                                       &ENDER::FrameArena::local());
+  for (uint j = colFirst; j < colLast; j++) {
+    auto Nu = uTable.sampleWeights(j, 0);
+    auto dNu = uTable.sampleWeights(j, 1);
+    auto first = uTable.spans[j] - _uDegree;
+    auto column = &columns[(j - colFirst) * _vCount];
+    auto dColumn = &dColumns[(j - colFirst) * _vCount];
+    for (auto k = 0; k <= _uDegree; k++) {
+      auto row = &_net[(first + k) * _vCount];
+      for (uint l = 0; l < _vCount; l++) {
+        column[l] += Nu[k] * row[l];
+        dColumn[l] += dNu[k] * row[l];
+      }
+    }
+  }
+
+  // Second pass: evaluate those curves at the row parameters.
+  for (uint i = rowFirst; i < rowLast; i++) {
+    auto Nv = vTable.sampleWeights(i, 0);
+    auto dNv = vTable.sampleWeights(i, 1);
+    auto first = vTable.spans[i] - _vDegree;
+    for (uint j = colFirst; j < colLast; j++) {
+      auto offset = (j - colFirst) * _vCount + first;
+      auto column = &columns[offset];
+      auto dColumn = &dColumns[offset];
+      glm::vec4 S{0.0f};
+      glm::vec4 Su{0.0f};
+      glm::vec4 Sv{0.0f};
+      for (auto l = 0; l <= _vDegree; l++) {
+        S += Nv[l] * column[l];
+        Su += Nv[l] * dColumn[l];
+        Sv += dNv[l] * column[l];
+      }
+      // Quotient rule for the rational surface.
+      auto point = glm::vec3(S) / S.w;
+      _setVertex(lod, i, j, point, (glm::vec3(Su) - Su.w * point) / S.w,
+                 (glm::vec3(Sv) - Sv.w * point) / S.w);
+    }
+  }
+}
+
+bool NurbsSurface::_getGpuSurface(GpuSurface &surface) {
+  if (std::max(_uDegree, _vDegree) > SPLINE_GPU_MAX_DEGREE)
+    return false;
+  surface.type = GpuSurfaceType::Nurbs;
+  surface.uDegree = _uDegree;
+  surface.vDegree = _vDegree;
+  surface.uCount = _uCount;
+  surface.vCount = _vCount;
+  surface.knots = _uKnots;
+  surface.knots.insert(surface.knots.end(), _vKnots.begin(), _vKnots.end());
+  surface.controlPoints = _net;
+  return true;
+}
+
+void NurbsSurface::drawProperties() {
+  Surface::drawProperties();
+  bool shouldUpdate = false;
+  if (ImGui::TreeNode("NURBS Surface")) {
+    shouldUpdate = ImGui::InputInt("U Degree", &_uDegree);
+    shouldUpdate = ImGui::InputInt("V Degree", &_vDegree) || shouldUpdate;
+    if (shouldUpdate) {
+      // Knot vectors depend on the degree, let them be regenerated.
+      _uKnots.clear();
+      _vKnots.clear();
+    }
+
+    if (ImGui::TreeNode("Control Net")) {
+      for (uint i = 0; i < _uCount; i++)
+        for (uint j = 0; j < _vCount; j++) {
+          auto index = i * _vCount + j;
+          auto position = _controlPoints[index];
+          auto weight = _weights[index];
+          auto label = "P_" + std::to_string(i) + "_" + std::to_string(j);
+          bool moved =
+              ImGui::DragFloat3(label.c_str(), glm::value_ptr(position), 0.1f);
+          moved = ImGui::DragFloat((label + "_w").c_str(), &weight, 0.05f, 0.01f,
+                                   5.0f) ||
+                  moved;
+          if (moved)
+            setControlPoint(i, j, position, weight);
+        }
+      ImGui::TreePop();
+    }
+    ImGui::TreePop();
+  }
+  if (shouldUpdate)
+    markDirty();
+}
+
+} // namespace EGEOM
@@ -14,11 +14,13 @@ EGEOM::PivotPlane::PivotPlane(const std::string &name,
 
 sptr<EGEOM::PivotPlane> EGEOM::PivotPlane::create(const std::string &name) {
   if (!planeVAO) {
+    ENDER::GpuMemory::OwnerScope owner("PivotPlane");
     auto planeLayout = uptr<ENDER::BufferLayout>(
         new ENDER::BufferLayout({{ENDER::LayoutObjectType::Float3},
                                  {ENDER::LayoutObjectType::Float2}}));
     auto planeVBO =
-        std::make_unique<ENDER::VertexBuffer>(std::move(planeLayout));
+        std::make_unique<ENDER::VertexBuffer>(std::move(planeLayout),
+                                             ENDER::BufferUsage::Static);
     planeVBO->setData(planeVertices, sizeof(planeVertices));
     auto planeIBO = std::make_unique<ENDER::IndexBuffer>(planeIndices, 6);
     planeVAO = std::make_shared<ENDER::VertexArray>();
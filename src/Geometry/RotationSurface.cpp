@@ -12,6 +12,7 @@ RotationSurface::RotationSurface(const std::string &name,
                                  float rotationRadius)
     : Surface(name), _baseSpline(baseSpline), _rotationRadius(rotationRadius),
       _rotationAngle(rotationAngle) {
+  _addDependency(_baseSpline, true);
   update();
 }
 
@@ -23,13 +24,9 @@ sptr<RotationSurface> RotationSurface::create(const std::string &name,
       new RotationSurface(name, baseSpline, rotationAngle, rotationRadius));
 }
 
-void RotationSurface::update() { // FIXME: set vbo data ideally but i am too
-                                 // lazy now
-  auto vao = ENDER::Utils::createParametricSurfaceVAO(
-      [&](float u, float v) { return pointOnSurface(u, v); }, 0, 0, 1,
-      _rotationAngle, SURFACE_ROWS, SURFACE_COLS);
-
-  setVertexArray(vao);
+void RotationSurface::update() {
+  _vMax = _rotationAngle;
+  invalidate();
 }
 
 glm::vec3 RotationSurface::pointOnSurface(float u, float v) {
@@ -40,9 +37,42 @@ glm::vec3 RotationSurface::pointOnSurface(float u, float v) {
                    splinePoint.z};
 }
 
+void RotationSurface::_evaluateGrid(SurfaceLod &lod, uint rowFirst,
+                                    uint rowLast, uint colFirst,
+                                    uint colLast) {
+  // Point and tangent of the curve per column of the block.
+  auto curve =
+      _baseSpline->evaluateBatch(_paramRange(lod.us, colFirst, colLast), 1);
+  for (uint i = rowFirst; i < rowLast; i++) {
+    float c = glm::cos(lod.vs[i]);
+    float s = glm::sin(lod.vs[i]);
+    for (uint j = colFirst; j < colLast; j++) {
+      auto k = (j - colFirst) * 2;
+      auto splinePoint = curve[k] + glm::vec3{-_rotationRadius, 0, 0};
+      auto tangent = curve[k + 1];
+      _setVertex(lod, i, j,
+                 glm::vec3{_rotationRadius, 0, 0} +
+                     glm::vec3{splinePoint.x * c, splinePoint.x * s,
+                               splinePoint.z},
+                 glm::vec3{tangent.x * c, tangent.x * s, tangent.z},
+                 glm::vec3{-splinePoint.x * s, splinePoint.x * c, 0});
+    }
+  }
+}
+
+bool RotationSurface::_getGpuSurface(GpuSurface &surface) {
+  if (!_baseSpline->getBSplineForm(surface.uDegree, surface.knots,
+                                   surface.controlPoints))
+    return false;
+  surface.type = GpuSurfaceType::Rotation;
+  surface.rotationRadius = _rotationRadius;
+  surface.uCount = surface.controlPoints.size();
+  return true;
+}
+
 void RotationSurface::drawProperties() {
 
-  ENDER::Object::drawProperties();
+  Surface::drawProperties();
 
   bool shouldUpdate = false;
 
@@ -54,7 +84,7 @@ void RotationSurface::drawProperties() {
     ImGui::TreePop();
   }
   if (shouldUpdate)
-    update();
+    markDirty();
 }
 
 void RotationSurface::drawGizmo() {
@@ -1,4 +1,6 @@
 #include <Spline1.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace EGEOM {
 Spline1::Spline1(const std::vector<sptr<Point>> &points,
@@ -12,34 +14,109 @@ Spline1::Spline1(const std::vector<sptr<Point>> &points,
       points, LinearInterpolationBuilder::ParamMethod::Uniform);
   _interpolatedPointsCount = interpolatedPointsCount;
 
+  ENDER::GpuMemory::OwnerScope owner(_name);
   auto layout = uptr<ENDER::BufferLayout>(
       new ENDER::BufferLayout({{ENDER::LayoutObjectType::Float3}}));
 
-  auto vbo = std::make_unique<ENDER::VertexBuffer>(std::move(layout));
+  // Rewritten as a whole on most edits, dragging a point sends just the moved
+  // span.
+  auto vbo = std::make_unique<ENDER::VertexBuffer>(std::move(layout),
+                                                  ENDER::BufferUsage::Stream);
   vbo->setData(&_rawData[0], _rawData.size() * sizeof(float));
-  _vertexArray = std::make_shared<ENDER::VertexArray>();
-  _vertexArray->addVBO(std::move(vbo));
+  _lineVertexArray = std::make_shared<ENDER::VertexArray>();
+  _lineVertexArray->addVBO(std::move(vbo));
+  _vertexArray = _lineVertexArray;
 
   _calculateDrawPoints();
 }
 
 void Spline1::_calculateDrawPoints() {
+  ENDER::FrameArenaScope scratch;
   if (_splineBuilder->points.size() < 2)
     return;
 
-  _interpolatedPoints.clear();
-  for (auto i = 0; i < _interpolatedPointsCount; i++) {
-    float t = i * 1.f / (_interpolatedPointsCount - 1);
-    _interpolatedPoints.push_back(_splineBuilder->getSplinePoint(t));
+  if (_gpuEvaluation) {
+    if (_uploadGpuData())
+      return;
+    spdlog::warn("Spline1: curve has no B-spline form of degree <= {}, "
+                 "falling back to CPU evaluation.",
+                 SPLINE_GPU_MAX_DEGREE);
+    _setGpuMode(false);
   }
 
+  // Existing points and storage are reused, only growth allocates.
+  while (_interpolatedPoints.size() < _interpolatedPointsCount)
+    _interpolatedPoints.push_back(Point::create({0, 0, 0}));
+  _interpolatedPoints.resize(_interpolatedPointsCount);
+
+  if (_sampleParams.size() != _interpolatedPointsCount) {
+    _sampleParams.resize(_interpolatedPointsCount);
+    for (auto i = 0; i < _interpolatedPointsCount; i++)
+      _sampleParams[i] = i * 1.f / (_interpolatedPointsCount - 1);
+  }
+
+  auto positions = evaluateBatch(_sampleParams);
+
   _rawData.clear();
-  for (auto point : _interpolatedPoints) {
-    _rawData.insert(_rawData.end(),
-                    {point->getPosition().x, point->getPosition().y,
-                     point->getPosition().z});
+  for (auto i = 0; i < _interpolatedPointsCount; i++) {
+    auto position = positions[i];
+    _interpolatedPoints[i]->setPosition(position);
+    _rawData.insert(_rawData.end(), {position.x, position.y, position.z});
   }
-  _vertexArray->setVBOdata(0, &_rawData[0], _rawData.size() * sizeof(float));
+  _lineVertexArray->setVBOdata(0, &_rawData[0],
+                               _rawData.size() * sizeof(float));
+}
+
+bool Spline1::getBSplineForm(int &degree, std::vector<float> &knots,
+                             std::vector<glm::vec4> &controlPoints) {
+  return _splineBuilder->points.size() >= 2 &&
+         _splineBuilder->getBSplineForm(degree, knots, controlPoints) &&
+         degree <= SPLINE_GPU_MAX_DEGREE;
+}
+
+bool Spline1::_uploadGpuData() {
+  if (!getBSplineForm(_gpuDegree, _gpuKnots, _gpuControlPoints))
+    return false;
+
+  _gpuControlPointsBuffer->setData(
+      glm::value_ptr(_gpuControlPoints[0]),
+      _gpuControlPoints.size() * sizeof(glm::vec4));
+  _gpuKnotsBuffer->setData(&_gpuKnots[0], _gpuKnots.size() * sizeof(float));
+  _gpuVertexArray->setVertexCount(_gpuSamplesCount);
+  return true;
+}
+
+void Spline1::_setGpuMode(bool enabled) {
+  _gpuEvaluation = enabled;
+  if (enabled && _gpuVertexArray == nullptr) {
+    ENDER::GpuMemory::OwnerScope owner(_name);
+    _gpuControlPointsBuffer = std::make_unique<ENDER::TextureBuffer>(GL_RGBA32F);
+    _gpuKnotsBuffer = std::make_unique<ENDER::TextureBuffer>(GL_R32F);
+    _gpuVertexArray = std::make_shared<ENDER::VertexArray>();
+  }
+  _vertexArray = enabled ? _gpuVertexArray : _lineVertexArray;
+  _shader = enabled ? ENDER::Renderer::getSplineShader() : nullptr;
+}
+
+void Spline1::setGpuEvaluation(bool enabled) {
+  if (enabled == _gpuEvaluation)
+    return;
+  _setGpuMode(enabled);
+  // Leaving GPU mode also refreshes the stale CPU samples.
+  _calculateDrawPoints();
+}
+
+void Spline1::bindShaderResources(ENDER::Shader &shader) {
+  if (!_gpuEvaluation)
+    return;
+  shader.setVec3("material.ambient", material.ambient);
+  _gpuControlPointsBuffer->bind(0);
+  _gpuKnotsBuffer->bind(1);
+  shader.setInt("controlPoints", 0);
+  shader.setInt("knots", 1);
+  shader.setInt("degree", _gpuDegree);
+  shader.setInt("pointsCount", _gpuControlPoints.size());
+  shader.setInt("samplesCount", _gpuSamplesCount);
 }
 
 void Spline1::setPoints(const std::vector<sptr<Point>> &points) {
@@ -58,6 +135,64 @@ void Spline1::setInterpolationPointsCount(uint count) {
 void Spline1::update() {
   _splineBuilder->rebuild();
   _calculateDrawPoints();
+  _notifyChanged(0.0f, 1.0f);
+}
+
+void Spline1::updatePoint(uint index) {
+  ENDER::FrameArenaScope scratch;
+  if (_gpuEvaluation && index < _gpuControlPoints.size()) {
+    // Only the moved control point is uploaded, 16 bytes.
+    _splineBuilder->updatePoint(index);
+    _gpuControlPoints[index] = _splineBuilder->getHomogeneousPoint(index);
+    _gpuControlPointsBuffer->setSubData(
+        index * sizeof(glm::vec4), glm::value_ptr(_gpuControlPoints[index]),
+        sizeof(glm::vec4));
+    auto [from, to] = _splineBuilder->getAffectedInterval(index);
+    _notifyChanged(from, to);
+    return;
+  }
+
+  if (index >= _splineBuilder->points.size() ||
+      _splineBuilder->points.size() < 2 ||
+      _interpolatedPoints.size() != _interpolatedPointsCount) {
+    update();
+    return;
+  }
+
+  _splineBuilder->updatePoint(index);
+  auto [from, to] = _splineBuilder->getAffectedInterval(index);
+
+  int last = _interpolatedPointsCount - 1;
+  int first = std::clamp<int>(std::floor(from * last), 0, last);
+  int end = std::clamp<int>(std::ceil(to * last), 0, last);
+
+  for (auto i = first; i <= end; i++) {
+    float t = i * 1.f / last;
+    auto position = _splineBuilder->evaluate(t);
+    _interpolatedPoints[i]->setPosition(position);
+    _rawData[i * 3] = position.x;
+    _rawData[i * 3 + 1] = position.y;
+    _rawData[i * 3 + 2] = position.z;
+  }
+  _lineVertexArray->setVBOsubData(0, first * 3 * sizeof(float),
+                                  &_rawData[first * 3],
+                                  (end - first + 1) * 3 * sizeof(float));
+
+  _notifyChanged(from, to);
+}
+
+int Spline1::addChangeCallback(changeCallback callback) {
+  int key = _nextCallbackKey++;
+  _changeCallbacks.insert({key, callback});
+  return key;
+}
+
+void Spline1::deleteChangeCallback(int key) { _changeCallbacks.erase(key); }
+
+void Spline1::_notifyChanged(float from, float to) {
+  _version++;
+  for (auto &[key, callback] : _changeCallbacks)
+    callback(from, to);
 }
 
 void Spline1::addPoint(sptr<Point> point) {
@@ -123,27 +258,38 @@ void Spline1::getPropertiesGUI(bool scrollToPoint) {
     }
   }
 
+  bool gpuEvaluation = _gpuEvaluation;
+  if (ImGui::Checkbox("GPU Evaluation", &gpuEvaluation))
+    setGpuEvaluation(gpuEvaluation);
+  if (_gpuEvaluation &&
+      ImGui::DragInt("GPU Samples", &_gpuSamplesCount, 16, 2, 1 << 16))
+    _gpuVertexArray->setVertexCount(std::max(_gpuSamplesCount, 2));
+
   if (ImGui::TreeNode("Points")) {
     ImGui::BeginGroup();
     const bool child_is_visible = ImGui::BeginChild("pefe", {0, 200});
 
     if (child_is_visible) {
       auto i = 0;
+      int changedPoint = -1;
       for (auto point : _splineBuilder->points) {
         auto point_name = std::string("Point_") + std::to_string(i);
         if (point->selected()) {
           ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(0, 255, 0, 255));
-          ImGui::InputFloat3(point_name.c_str(),
-                             glm::value_ptr(point->getPosition()));
+          if (ImGui::InputFloat3(point_name.c_str(),
+                                 glm::value_ptr(point->getPosition())))
+            changedPoint = i;
           ImGui::PopStyleColor();
           if (scrollToPoint)
             ImGui::SetScrollHereY(0.25f);
-        } else
-          ImGui::InputFloat3(point_name.c_str(),
-                             glm::value_ptr(point->getPosition()));
+        } else if (ImGui::InputFloat3(point_name.c_str(),
+                                      glm::value_ptr(point->getPosition())))
+          changedPoint = i;
         i++;
         // }
       }
+      if (changedPoint != -1)
+        updatePoint(changedPoint);
     }
     ImGui::EndChild();
     ImGui::EndGroup();
@@ -183,8 +329,120 @@ void Spline1::getPropertiesGUI(bool scrollToPoint) {
 Spline1::SplineType Spline1::getSplineType() const { return _splineType; }
 
 glm::vec3 Spline1::getSplinePoint(float u) {
-  auto point = _splineBuilder->getSplinePoint(u);
-  return point->getPosition();
+  return _splineBuilder->evaluate(u);
+}
+
+std::pmr::vector<glm::vec3>
+Spline1::evaluateBatch(const std::vector<float> &params, int dirsCount) {
+  std::pmr::vector<glm::vec3> result(&ENDER::FrameArena::local());
+  _splineBuilder->evaluateBatch(params, dirsCount, result);
+  return result;
+}
+
+// One step of the double reflection method: transports the normal of frame
+// from its point to (point, tangent).
+static SplineFrame reflectFrame(const SplineFrame &frame,
+                                const glm::vec3 &point,
+                                const glm::vec3 &tangent) {
+  SplineFrame result{point, tangent, frame.normal, frame.binormal};
+
+  auto v1 = point - frame.point;
+  float c1 = glm::dot(v1, v1);
+  auto normal = frame.normal;
+  auto reflectedTangent = frame.tangent;
+  if (c1 > 1e-12f) {
+    normal -= (2.0f / c1) * glm::dot(v1, normal) * v1;
+    reflectedTangent -= (2.0f / c1) * glm::dot(v1, reflectedTangent) * v1;
+  }
+
+  auto v2 = tangent - reflectedTangent;
+  float c2 = glm::dot(v2, v2);
+  if (c2 > 1e-12f)
+    normal -= (2.0f / c2) * glm::dot(v2, normal) * v2;
+
+  result.normal = glm::normalize(normal - glm::dot(normal, tangent) * tangent);
+  result.binormal = glm::cross(tangent, result.normal);
+  return result;
+}
+
+static glm::vec3 frameTangent(const glm::vec3 &derivative,
+                              const glm::vec3 &fallback) {
+  if (glm::length(derivative) > 1e-6f)
+    return glm::normalize(derivative);
+  return fallback;
+}
+
+static SplineFrame frameFromTable(const std::vector<SplineFrame> &table,
+                                  float u, const glm::vec3 &point,
+                                  const glm::vec3 &derivative) {
+  int sample = std::clamp<int>(u * (table.size() - 1), 0, table.size() - 1);
+  auto &start = table[sample];
+  return reflectFrame(start, point, frameTangent(derivative, start.tangent));
+}
+
+const std::vector<SplineFrame> &Spline1::_getFrameTable() {
+  if (!_frames.empty() && _framesVersion == _version)
+    return _frames;
+
+  std::vector<float> params(SPLINE_FRAME_SAMPLES);
+  for (auto i = 0; i < SPLINE_FRAME_SAMPLES; i++)
+    params[i] = i * 1.f / (SPLINE_FRAME_SAMPLES - 1);
+  auto ders = evaluateBatch(params, 1);
+
+  _frames.resize(SPLINE_FRAME_SAMPLES);
+
+  // Chord directions stand in for the tangent where the builder has no
+  // derivatives.
+  auto chord = [&](int i) {
+    int a = std::min<int>(i, SPLINE_FRAME_SAMPLES - 2);
+    auto d = ders[(a + 1) * 2] - ders[a * 2];
+    return glm::length(d) > 1e-6f ? glm::normalize(d) : glm::vec3{1, 0, 0};
+  };
+
+  auto t0 = frameTangent(ders[1], chord(0));
+  // Start from the axis least aligned with the tangent.
+  auto axis = glm::abs(t0.x) < glm::abs(t0.y)
+                  ? (glm::abs(t0.x) < glm::abs(t0.z) ? glm::vec3{1, 0, 0}
+                                                     : glm::vec3{0, 0, 1})
+                  : (glm::abs(t0.y) < glm::abs(t0.z) ? glm::vec3{0, 1, 0}
+                                                     : glm::vec3{0, 0, 1});
+  auto r0 = glm::normalize(axis - glm::dot(axis, t0) * t0);
+  _frames[0] = {ders[0], t0, r0, glm::cross(t0, r0)};
+
+  for (auto i = 1; i < SPLINE_FRAME_SAMPLES; i++)
+    _frames[i] = reflectFrame(_frames[i - 1], ders[i * 2],
+                              frameTangent(ders[i * 2 + 1], chord(i)));
+
+  _framesVersion = _version;
+  return _frames;
+}
+
+std::pmr::vector<SplineFrame>
+Spline1::getRotationMinimizingFrames(const std::vector<float> &params) {
+  auto &table = _getFrameTable();
+  auto ders = evaluateBatch(params, 1);
+
+  std::pmr::vector<SplineFrame> frames(&ENDER::FrameArena::local());
+  frames.reserve(params.size());
+  for (auto i = 0; i < params.size(); i++)
+    frames.push_back(
+        frameFromTable(table, params[i], ders[i * 2], ders[i * 2 + 1]));
+  return frames;
+}
+
+SplineFrame Spline1::getRotationMinimizingFrame(float u) {
+  ENDER::FrameArenaScope scratch;
+  auto &table = _getFrameTable();
+  auto ders = getSplineDerivatives(u, 1);
+  return frameFromTable(table, u, _splineBuilder->evaluate(u),
+                        ders.size() > 1 ? ders[1] : glm::vec3{0, 0, 0});
+}
+
+std::pmr::vector<glm::vec3> Spline1::getSplineDerivatives(float u,
+                                                          int dirsCount) {
+  std::pmr::vector<glm::vec3> ders(&ENDER::FrameArena::local());
+  _splineBuilder->evaluateDerivatives(u, dirsCount, ders);
+  return ders;
 }
 
 std::vector<sptr<Point>> Spline1::getSplineDirs(float u, int dirsCount) {
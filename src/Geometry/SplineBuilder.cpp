@@ -3,6 +3,48 @@
 #include <ranges>
 
 namespace EGEOM {
+sptr<Point> SplineBuilder::getSplinePoint(float t) {
+  return Point::create(evaluate(t));
+}
+
+std::vector<sptr<Point>> SplineBuilder::getSplineDerivatives(float t,
+                                                             int dirsCount) {
+  std::pmr::vector<glm::vec3> ders(&ENDER::FrameArena::local());
+  evaluateDerivatives(t, dirsCount, ders);
+  std::vector<sptr<Point>> result;
+  for (auto &d : ders)
+    result.push_back(Point::create(d));
+  return result;
+}
+
+void SplineBuilder::evaluateBatch(const std::vector<float> &params,
+                                  int dirsCount,
+                                  std::pmr::vector<glm::vec3> &out) {
+  out.assign(params.size() * (dirsCount + 1), glm::vec3(0.0f));
+  if (dirsCount == 0) {
+    for (auto i = 0; i < params.size(); i++)
+      out[i] = evaluate(params[i]);
+    return;
+  }
+  std::pmr::vector<glm::vec3> ders(&ENDER::FrameArena::local());
+  for (auto i = 0; i < params.size(); i++) {
+    evaluateDerivatives(params[i], dirsCount, ders);
+    auto row = &out[i * (dirsCount + 1)];
+    if (ders.empty()) {
+      // No derivatives from the builder, the tangent is a central difference.
+      float t = params[i];
+      float h = 1e-3f;
+      row[0] = evaluate(t);
+      row[1] = (evaluate(std::min(t + h, 1.0f)) -
+                evaluate(std::max(t - h, 0.0f))) /
+               (std::min(t + h, 1.0f) - std::max(t - h, 0.0f));
+      continue;
+    }
+    for (auto k = 0; k < ders.size() && k <= dirsCount; k++)
+      row[k] = ders[k];
+  }
+}
+
 /////////////////////////////////////
 /// LinearInterpolationBuilder
 /////////////////////////////////////
@@ -15,7 +57,7 @@ LinearInterpolationBuilder::LinearInterpolationBuilder(
 
 void LinearInterpolationBuilder::rebuild() { calculateParameter(); };
 
-sptr<Point> LinearInterpolationBuilder::getSplinePoint(float t) {
+glm::vec3 LinearInterpolationBuilder::evaluate(float t) {
   uint j = 0;
   while (t > _t[j + 1])
     j++;
@@ -31,7 +73,21 @@ sptr<Point> LinearInterpolationBuilder::getSplinePoint(float t) {
   pointPosition.z = points[j]->getPosition().z * (1.0f - omega) +
                     points[j + 1]->getPosition().z * omega;
 
-  return Point::create(pointPosition);
+  return pointPosition;
+}
+
+std::pair<float, float>
+LinearInterpolationBuilder::getAffectedInterval(uint index) {
+  if (index >= _t.size())
+    return {0.0f, 1.0f};
+  return {_t[index > 0 ? index - 1 : 0],
+          _t[std::min<uint>(index + 1, _t.size() - 1)]};
+}
+
+void LinearInterpolationBuilder::updatePoint(uint index) {
+  // Uniform parameter does not depend on point positions.
+  if (paramMethod != ParamMethod::Uniform)
+    calculateParameter();
 }
 
 bool LinearInterpolationBuilder::drawPropertiesGui() {
@@ -88,8 +144,8 @@ void LinearInterpolationBuilder::calculateUniformParameter() {
 /// BezierBuilder
 /////////////////////////////////////
 
-std::vector<float> BezierBuilder::_allBernstein(float u) {
-  std::vector<float> B(bezierPower + 1, 0);
+std::pmr::vector<float> BezierBuilder::_allBernstein(float u) {
+  std::pmr::vector<float> B(bezierPower + 1, 0, &ENDER::FrameArena::local());
   B[0] = 1.0f;
   float u1 = 1.0f - u;
   for (int j = 1; j <= bezierPower; j++) {
@@ -104,24 +160,23 @@ std::vector<float> BezierBuilder::_allBernstein(float u) {
   return B;
 }
 
-sptr<Point> BezierBuilder::_deCasteljau(float u) {
-  std::vector<glm::vec3> _glmPointsCopy;
-  std::copy(_glmPoints.begin(), _glmPoints.end(),
-            std::back_inserter(_glmPointsCopy));
+glm::vec3 BezierBuilder::_deCasteljau(float u) {
+  std::pmr::vector<glm::vec3> _glmPointsCopy(
+      _glmPoints.begin(), _glmPoints.end(), &ENDER::FrameArena::local());
   for (int k = 1; k <= bezierPower; k++) {
     for (int i = 0; i < bezierPower - k + 1; i++) {
       _glmPointsCopy[i] =
           (1.0f - u) * _glmPointsCopy[i] + u * _glmPointsCopy[i + 1];
     }
   }
-  return Point::create(_glmPointsCopy[0]);
+  return _glmPointsCopy[0];
 }
 
-sptr<Point> BezierBuilder::pointWithAllBernstein(float u) {
+glm::vec3 BezierBuilder::pointWithAllBernstein(float u) {
   auto B = _allBernstein(u);
-  auto C = Point::create({0, 0, 0});
+  glm::vec3 C = {0, 0, 0};
   for (int k = 0; k <= bezierPower; k++) {
-    *C = *C + B[k] * (*(points[k]));
+    C += B[k] * points[k]->getPosition();
   }
   return C;
 }
@@ -132,7 +187,7 @@ BezierBuilder::BezierBuilder(const std::vector<sptr<Point>> &points,
                              int bezierPower)
     : SplineBuilder(points), bezierPower(bezierPower) {}
 
-sptr<Point> BezierBuilder::getSplinePoint(float t) {
+glm::vec3 BezierBuilder::evaluate(float t) {
   if (useDeCasteljau) {
     return _deCasteljau(t);
   }
@@ -148,6 +203,14 @@ void BezierBuilder::rebuild() {
   std::copy(glmPoints.begin(), glmPoints.end(), std::back_inserter(_glmPoints));
 }
 
+void BezierBuilder::updatePoint(uint index) {
+  if (index >= _glmPoints.size()) {
+    rebuild();
+    return;
+  }
+  _glmPoints[index] = points[index]->getPosition();
+}
+
 bool BezierBuilder::drawPropertiesGui() {
   ImGui::Text("Bezier Curve Power: %d", bezierPower);
   return false;
@@ -157,8 +220,8 @@ bool BezierBuilder::drawPropertiesGui() {
 /// RationalBezierBuilder
 /////////////////////////////////////
 
-std::vector<float> RationalBezierBuilder::_allBernstein(float u) {
-  std::vector<float> B(bezierPower + 1, 0);
+std::pmr::vector<float> RationalBezierBuilder::_allBernstein(float u) {
+  std::pmr::vector<float> B(bezierPower + 1, 0, &ENDER::FrameArena::local());
   B[0] = 1.0f;
   float u1 = 1.0f - u;
   for (int j = 1; j <= bezierPower; j++) {
@@ -173,10 +236,9 @@ std::vector<float> RationalBezierBuilder::_allBernstein(float u) {
   return B;
 }
 
-sptr<Point> RationalBezierBuilder::_deCasteljau(float u) {
-  std::vector<glm::vec3> _glmPointsCopy;
-  std::copy(_glmPoints.begin(), _glmPoints.end(),
-            std::back_inserter(_glmPointsCopy));
+glm::vec3 RationalBezierBuilder::_deCasteljau(float u) {
+  std::pmr::vector<glm::vec3> _glmPointsCopy(
+      _glmPoints.begin(), _glmPoints.end(), &ENDER::FrameArena::local());
   for (auto i = 0; i < _glmPointsCopy.size(); i++) {
     _glmPointsCopy[i] *= w[i];
   }
@@ -186,7 +248,7 @@ sptr<Point> RationalBezierBuilder::_deCasteljau(float u) {
           (1.0f - u) * _glmPointsCopy[i] + u * _glmPointsCopy[i + 1];
     }
   }
-  return Point::create(_glmPointsCopy[0]);
+  return _glmPointsCopy[0];
 }
 
 RationalBezierBuilder::RationalBezierBuilder(
@@ -201,15 +263,15 @@ RationalBezierBuilder::RationalBezierBuilder(
   }
 }
 
-sptr<Point> RationalBezierBuilder::getSplinePoint(float t) {
+glm::vec3 RationalBezierBuilder::evaluate(float t) {
   auto C = _deCasteljau(t);
   auto B = _allBernstein(t);
   float H = 0;
   for (int i = 0; i < w.size(); i++) {
     H += w[i] * B[i];
   }
-  C->getPosition().x /= H;
-  C->getPosition().z /= H;
+  C.x /= H;
+  C.z /= H;
   return C;
 }
 
@@ -222,6 +284,14 @@ void RationalBezierBuilder::rebuild() {
   std::copy(glmPoints.begin(), glmPoints.end(), std::back_inserter(_glmPoints));
 }
 
+void RationalBezierBuilder::updatePoint(uint index) {
+  if (index >= _glmPoints.size()) {
+    rebuild();
+    return;
+  }
+  _glmPoints[index] = points[index]->getPosition();
+}
+
 bool RationalBezierBuilder::drawPropertiesGui() {
   ImGui::Text("Bezier Curve Power: %d", bezierPower);
   bool updated = false;
@@ -291,33 +361,80 @@ BSplineBuilder::BSplineBuilder(const std::vector<sptr<Point>> &points,
   _checkAndSetDefault();
 }
 
-sptr<Point> BSplineBuilder::getSplinePoint(float t) {
+glm::vec3 BSplineBuilder::evaluate(float t) {
   int span = bSplineFindSpan(points.size() - 1, bSplinePower, t, knotVector);
   auto N = bSplineBasisFunc(span, t, bSplinePower, knotVector);
-  auto C = Point::create({0, 0, 0});
+  glm::vec3 C = {0, 0, 0};
   for (int i = 0; i <= bSplinePower; i++) {
-    *C = *C + N[i] * (*points[span - bSplinePower + i]);
+    C += N[i] * points[span - bSplinePower + i]->getPosition();
   }
   return C;
 }
 
-std::vector<sptr<Point>> BSplineBuilder::getSplineDerivatives(float t,
-                                                              int dirsCount) {
+void BSplineBuilder::evaluateDerivatives(float t, int dirsCount,
+                                         std::pmr::vector<glm::vec3> &ders) {
   int du = std::min(dirsCount, bSplinePower);
-  std::vector<sptr<Point>> result;
+  ders.clear();
   int span = bSplineFindSpan(points.size() - 1, bSplinePower, t, knotVector);
   auto nders = dersBasisFunc(span, t, bSplinePower, du, knotVector);
   for (auto k = 0; k <= du; k++) {
-    auto C = Point::create({0, 0, 0});
+    glm::vec3 C = {0, 0, 0};
     for (auto j = 0; j <= bSplinePower; j++) {
-      *C = *C + nders[k][j] * *points[span - bSplinePower + j];
+      C += nders[k][j] * points[span - bSplinePower + j]->getPosition();
+    }
+    ders.push_back(C);
+  }
+}
+
+void BSplineBuilder::evaluateBatch(const std::vector<float> &params,
+                                   int dirsCount,
+                                   std::pmr::vector<glm::vec3> &out) {
+  auto &table =
+      _basisTables.get(_knotVersion, bSplinePower, dirsCount, params,
+                       points.size() - 1, knotVector);
+  int stride = dirsCount + 1;
+  out.assign(params.size() * stride, glm::vec3(0.0f));
+  for (auto s = 0; s < params.size(); s++) {
+    int first = table.spans[s] - bSplinePower;
+    for (auto k = 0; k <= dirsCount; k++) {
+      auto N = table.sampleWeights(s, k);
+      glm::vec3 C = {0, 0, 0};
+      for (auto j = 0; j <= bSplinePower; j++)
+        C += N[j] * points[first + j]->getPosition();
+      out[s * stride + k] = C;
     }
-    result.push_back(C);
   }
-  return result;
 }
 
-void BSplineBuilder::rebuild() { _checkAndSetDefault(); }
+void BSplineBuilder::rebuild() {
+  _checkAndSetDefault();
+  // Point and weight edits keep the cached basis tables.
+  if (knotVector != _tableKnots || bSplinePower != _tablePower) {
+    _tableKnots = knotVector;
+    _tablePower = bSplinePower;
+    _knotVersion++;
+    _basisTables.clear();
+  }
+}
+
+std::pair<float, float> BSplineBuilder::getAffectedInterval(uint index) {
+  if (index + bSplinePower + 1 >= knotVector.size())
+    return {0.0f, 1.0f};
+  return {knotVector[index], knotVector[index + bSplinePower + 1]};
+}
+
+// Points are read directly in getSplinePoint, nothing is cached.
+void BSplineBuilder::updatePoint(uint index) {}
+
+bool BSplineBuilder::getBSplineForm(int &degree, std::vector<float> &knots,
+                                    std::vector<glm::vec4> &controlPoints) {
+  degree = bSplinePower;
+  knots = knotVector;
+  controlPoints.clear();
+  for (auto &point : points)
+    controlPoints.push_back(glm::vec4{point->getPosition(), 1.0f});
+  return true;
+}
 
 bool BSplineBuilder::drawPropertiesGui() {
   bool modified = false;
@@ -405,7 +522,7 @@ RationalBSplineBuilder::RationalBSplineBuilder(
   _checkAndSetDefault();
 }
 
-sptr<Point> RationalBSplineBuilder::getSplinePoint(float t) {
+glm::vec3 RationalBSplineBuilder::evaluate(float t) {
   // int span = bSplineFindSpan(points.size() - 1, bSplinePower, t,
   // knotVector); auto N = bSplineBasisFunc(span, t, bSplinePower,
   // knotVector); glm::vec4 C = {0, 0, 0, 0}; float H = 0.0f;
@@ -416,14 +533,16 @@ sptr<Point> RationalBSplineBuilder::getSplinePoint(float t) {
   // }
   // return Point::create({C.x / H, C.y / H, C.z / H});
 
-  auto ck = getSplineDerivatives(t, 2);
+  std::pmr::vector<glm::vec3> ck(&ENDER::FrameArena::local());
+  evaluateDerivatives(t, 0, ck);
   return ck[0];
 }
 
-std::vector<sptr<Point>>
-RationalBSplineBuilder::getSplineDerivatives(float t, int dirsCount) {
+void RationalBSplineBuilder::evaluateDerivatives(
+    float t, int dirsCount, std::pmr::vector<glm::vec3> &ders) {
+  auto arena = &ENDER::FrameArena::local();
   int du = std::min(dirsCount, bSplinePower);
-  std::vector<glm::vec4> c4d;
+  std::pmr::vector<glm::vec4> c4d(arena);
   int span = bSplineFindSpan(points.size() - 1, bSplinePower, t, knotVector);
   auto nders = dersBasisFunc(span, t, bSplinePower, du, knotVector);
   for (auto k = 0; k <= du; k++) {
@@ -433,15 +552,16 @@ RationalBSplineBuilder::getSplineDerivatives(float t, int dirsCount) {
     }
     c4d.push_back(C);
   }
-  std::vector<glm::vec3> aders;
-  std::vector<float> wders;
+  std::pmr::vector<glm::vec3> aders(arena);
+  std::pmr::vector<float> wders(arena);
 
   for (auto &p : c4d) {
     aders.push_back({p.x, p.y, p.z});
     wders.push_back(p.w);
   }
 
-  std::vector<glm::vec3> CK;
+  auto &CK = ders;
+  CK.clear();
 
   for (auto k = 0; k <= du; k++) {
     auto v = aders[k];
@@ -450,16 +570,50 @@ RationalBSplineBuilder::getSplineDerivatives(float t, int dirsCount) {
     }
     CK.push_back(v / wders[0]);
   }
+}
 
-  std::vector<sptr<Point>> result;
-  for (auto &p : CK) {
-    result.push_back(Point::create(p));
+void RationalBSplineBuilder::_rationalDerivatives(const glm::vec4 *c4d, int du,
+                                                  glm::vec3 *ders) {
+  for (auto k = 0; k <= du; k++) {
+    glm::vec3 v = {c4d[k].x, c4d[k].y, c4d[k].z};
+    for (auto i = 1; i <= k; i++) {
+      v = v - binomialCoeff(k, i) * c4d[i].w * ders[k - i];
+    }
+    ders[k] = v / c4d[0].w;
+  }
+}
+
+void RationalBSplineBuilder::evaluateBatch(const std::vector<float> &params,
+                                           int dirsCount,
+                                           std::pmr::vector<glm::vec3> &out) {
+  auto &table =
+      _basisTables.get(_knotVersion, bSplinePower, dirsCount, params,
+                       points.size() - 1, knotVector);
+  int stride = dirsCount + 1;
+  out.assign(params.size() * stride, glm::vec3(0.0f));
+  std::pmr::vector<glm::vec4> c4d(stride, glm::vec4(0.0f),
+                                  &ENDER::FrameArena::local());
+  for (auto s = 0; s < params.size(); s++) {
+    int first = table.spans[s] - bSplinePower;
+    for (auto k = 0; k <= dirsCount; k++) {
+      auto N = table.sampleWeights(s, k);
+      glm::vec4 C = {0, 0, 0, 0};
+      for (auto j = 0; j <= bSplinePower; j++)
+        C += N[j] * _glmPoints[first + j];
+      c4d[k] = C;
+    }
+    _rationalDerivatives(c4d.data(), dirsCount, &out[s * stride]);
   }
-  return result;
 }
 
 void RationalBSplineBuilder::rebuild() {
   _checkAndSetDefault();
+  if (knotVector != _tableKnots || bSplinePower != _tablePower) {
+    _tableKnots = knotVector;
+    _tablePower = bSplinePower;
+    _knotVersion++;
+    _basisTables.clear();
+  }
   _glmPoints.clear();
   int i = 0;
   for (auto point : points) {
@@ -469,6 +623,35 @@ void RationalBSplineBuilder::rebuild() {
   }
 }
 
+std::pair<float, float>
+RationalBSplineBuilder::getAffectedInterval(uint index) {
+  if (index + bSplinePower + 1 >= knotVector.size())
+    return {0.0f, 1.0f};
+  return {knotVector[index], knotVector[index + bSplinePower + 1]};
+}
+
+void RationalBSplineBuilder::updatePoint(uint index) {
+  if (index >= _glmPoints.size() || index >= weights.size()) {
+    rebuild();
+    return;
+  }
+  auto pos = points[index]->getPosition();
+  _glmPoints[index] = glm::vec4{pos * weights[index], weights[index]};
+}
+
+bool RationalBSplineBuilder::getBSplineForm(
+    int &degree, std::vector<float> &knots,
+    std::vector<glm::vec4> &controlPoints) {
+  degree = bSplinePower;
+  knots = knotVector;
+  controlPoints = _glmPoints;
+  return true;
+}
+
+glm::vec4 RationalBSplineBuilder::getHomogeneousPoint(uint index) {
+  return _glmPoints[index];
+}
+
 bool RationalBSplineBuilder::drawPropertiesGui() {
   bool modified = false;
 
@@ -1,10 +1,629 @@
+#include "FrameArena.hpp"
 #include "Object.hpp"
+#include "imgui.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 #include <Surface.hpp>
+#include <algorithm>
+#include <functional>
+#include <string>
 
 namespace EGEOM {
 
-  Surface::Surface(const std::string &name) : ENDER::Object(name){
-    
+Surface::Surface(const std::string &name) : ENDER::Object(name) {
+  _lods.resize(SURFACE_LOD_COUNT);
+}
+
+Surface::~Surface() {
+  for (auto &dependency : _dependencies)
+    dependency.spline->deleteChangeCallback(dependency.callbackKey);
+}
+
+void Surface::_addDependency(const sptr<Spline1> &spline, bool alongU) {
+  auto key = spline->addChangeCallback([this, alongU](float from, float to) {
+    _onDependencyChanged(alongU, from, to);
+  });
+  _dependencies.push_back({spline, key, alongU, spline->getVersion()});
+}
+
+void Surface::_onDependencyChanged(bool alongU, float from, float to) {
+  _markRegionDirty(alongU, from, to);
+}
+
+void Surface::markDirty() {
+  _dirty = true;
+  ENDER::Window::requestRedraw();
+}
+
+bool Surface::isDirty() const {
+  if (_dirty || _dirtyU || _dirtyV)
+    return true;
+  for (auto &dependency : _dependencies)
+    if (dependency.spline->getVersion() != dependency.version)
+      return true;
+  return false;
+}
+
+void Surface::_markRegionDirty(bool alongU, float from, float to) {
+  auto &dirty = alongU ? _dirtyU : _dirtyV;
+  auto &range = alongU ? _dirtyURange : _dirtyVRange;
+  range = dirty ? glm::vec2{glm::min(range.x, from), glm::max(range.y, to)}
+                : glm::vec2{from, to};
+  dirty = true;
+  ENDER::Window::requestRedraw();
+
+  float min = alongU ? _uMin : _vMin;
+  float max = alongU ? _uMax : _vMax;
+  if (range.x <= min && range.y >= max)
+    _dirty = true;
+}
+
+void Surface::_flushChanges() {
+  if (!isDirty())
+    return;
+
+  // Version moved without a reported interval, rebuild everything.
+  if (_dirty || (!_dirtyU && !_dirtyV))
+    update();
+  else {
+    if (_dirtyU)
+      invalidateRegion(true, _dirtyURange.x, _dirtyURange.y);
+    if (_dirtyV)
+      invalidateRegion(false, _dirtyVRange.x, _dirtyVRange.y);
+  }
+
+  _dirty = _dirtyU = _dirtyV = false;
+  _contentVersion++;
+  for (auto &dependency : _dependencies)
+    dependency.version = dependency.spline->getVersion();
+}
+
+uint Surface::getLodRows(uint level) const {
+  // Adaptive levels are known only once built, until then the most they hold.
+  if (level < _lods.size() && !_lods[level].vs.empty())
+    return _lods[level].vs.size();
+  return std::max(SURFACE_ROWS >> level, 2u);
+}
+
+uint Surface::getLodCols(uint level) const {
+  if (level < _lods.size() && !_lods[level].us.empty())
+    return _lods[level].us.size();
+  return std::max(SURFACE_COLS >> level, 2u);
+}
+
+void Surface::setGpuTessellation(bool enabled) {
+  _gpuTessellation = enabled;
+  markDirty();
+}
+
+void Surface::setHardwareTessellation(bool enabled) {
+  _hardwareTessellation = enabled;
+  markDirty();
+}
+
+void Surface::setCompactVertices(bool enabled) {
+  _compactVertices = enabled;
+  markDirty();
+}
+
+void Surface::setTolerance(float tolerance) {
+  _tolerance = tolerance;
+  markDirty();
+}
+
+std::vector<float> Surface::_uniformParams(float min, float max,
+                                           uint count) const {
+  std::vector<float> params(count);
+  float h = (max - min) / (count - 1);
+  for (uint i = 0; i < count; i++)
+    params[i] = min + h * i;
+  params.back() = max;
+  return params;
+}
+
+std::vector<float> Surface::_adaptiveParams(bool alongU, uint maxSegments,
+                                            float tolerance) {
+  float min = alongU ? _uMin : _vMin;
+  float max = alongU ? _uMax : _vMax;
+  // Splits happen on a uniform grid of maxSegments segments, so the finest
+  // refinement reaches it exactly.
+  uint segments = std::max(maxSegments, 1u);
+  float step = (max - min) / segments;
+  auto param = [&](uint i) { return i == segments ? max : min + step * i; };
+
+  auto probes = alongU ? _uniformParams(_vMin, _vMax, SURFACE_REFINE_PROBES)
+                       : _uniformParams(_uMin, _uMax, SURFACE_REFINE_PROBES);
+
+  auto point = [&](float t, float s) {
+    return alongU ? pointOnSurface(t, s) : pointOnSurface(s, t);
+  };
+
+  float cosMaxBend = glm::cos(SURFACE_MAX_BEND_ANGLE);
+
+  auto isFlat = [&](float a, float b) {
+    float m = (a + b) * 0.5f;
+    for (auto s : probes) {
+      auto pa = point(a, s);
+      auto pb = point(b, s);
+      auto pm = point(m, s);
+      if (glm::length(pm - (pa + pb) * 0.5f) > tolerance)
+        return false;
+      auto d1 = pm - pa;
+      auto d2 = pb - pm;
+      float l1 = glm::length(d1);
+      float l2 = glm::length(d2);
+      if (l1 > tolerance && l2 > tolerance &&
+          glm::dot(d1, d2) < cosMaxBend * l1 * l2)
+        return false;
+    }
+    return true;
+  };
+
+  std::vector<float> params = {min};
+  std::function<void(uint, uint)> refine = [&](uint a, uint b) {
+    if (b - a > 1 && !isFlat(param(a), param(b))) {
+      refine(a, (a + b) / 2);
+      refine((a + b) / 2, b);
+    } else
+      params.push_back(param(b));
+  };
+
+  uint initial = std::min(SURFACE_MIN_SEGMENTS, segments);
+  for (uint i = 0; i < initial; i++)
+    refine(i * segments / initial, (i + 1) * segments / initial);
+
+  return params;
+}
+
+void Surface::_evaluateGrid(SurfaceLod &lod, uint rowFirst, uint rowLast,
+                            uint colFirst, uint colLast) {
+  float hu = (_uMax - _uMin) * 1e-3f;
+  float hv = (_vMax - _vMin) * 1e-3f;
+  for (uint i = rowFirst; i < rowLast; i++)
+    for (uint j = colFirst; j < colLast; j++) {
+      float u = lod.us[j];
+      float v = lod.vs[i];
+      auto du = pointOnSurface(glm::min(u + hu, _uMax), v) -
+                pointOnSurface(glm::max(u - hu, _uMin), v);
+      auto dv = pointOnSurface(u, glm::min(v + hv, _vMax)) -
+                pointOnSurface(u, glm::max(v - hv, _vMin));
+      _setVertex(lod, i, j, pointOnSurface(u, v), du, dv);
+    }
+}
+
+SurfaceLod Surface::_tessellate(std::vector<float> us, std::vector<float> vs) {
+  uint rows = vs.size();
+  uint cols = us.size();
+
+  ENDER::GpuMemory::OwnerScope owner(_name);
+  SurfaceLod lod;
+  lod.us = std::move(us);
+  lod.vs = std::move(vs);
+
+  GpuSurface gpuSurface;
+  bool onGpu = _gpuTessellation &&
+               GpuSurfaceEvaluator::getBackend() !=
+                   GpuSurfaceEvaluator::Backend::None &&
+               _getGpuSurface(gpuSurface);
+
+  auto &vertices = lod.vertices;
+  if (onGpu)
+    _estimateBounds();
+  else {
+    vertices.resize(rows * cols * SURFACE_VERTEX_SIZE);
+    _evaluateGrid(lod, 0, rows, 0, cols);
+
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+    for (uint i = 0; i < vertices.size(); i += SURFACE_VERTEX_SIZE) {
+      glm::vec3 vertice{vertices[i], vertices[i + 1], vertices[i + 2]};
+      min = glm::min(min, vertice);
+      max = glm::max(max, vertice);
+    }
+
+    _boundsCenter = (min + max) * 0.5f;
+    _boundsRadius = glm::length(max - min) * 0.5f;
+  }
+
+  std::vector<unsigned int> indices;
+  indices.reserve((rows - 1) * (cols - 1) * 6);
+  for (uint row = 0; row < rows - 1; row++) {
+    for (uint col = 0; col < cols - 1; col++) {
+      unsigned int f = col + row * cols;
+      unsigned int s1 = col + (row + 1) * cols;
+      unsigned int s2 = s1 + 1;
+      unsigned int t = f + 1;
+      indices.insert(indices.end(), {f, s1, s2, f, s2, t});
+    }
+  }
+
+  lod.compact = !onGpu && _compactVertices;
+
+  auto pool = ENDER::Renderer::getMeshPool();
+  if (!onGpu && !lod.compact && _useMeshPool && pool != nullptr) {
+    lod.mesh = pool->allocate(rows * cols, indices.size());
+    lod.mesh->setVertices(0, vertices.data(), rows * cols);
+    lod.mesh->setIndices(indices.data());
+    lod.vertexArray = pool->getVertexArray();
+    return lod;
+  }
+
+  // Position and normal, the evaluator writes the same layout.
+  auto layout = uptr<ENDER::BufferLayout>(
+      lod.compact
+          ? new ENDER::BufferLayout(
+                {{ENDER::LayoutObjectType::UShort4Norm,
+                  ENDER::AttributeLocation::Position},
+                 {ENDER::LayoutObjectType::Int2_10_10_10Norm,
+                  ENDER::AttributeLocation::Normal}})
+          : new ENDER::BufferLayout({{ENDER::LayoutObjectType::Float3,
+                                      ENDER::AttributeLocation::Position},
+                                     {ENDER::LayoutObjectType::Float3,
+                                      ENDER::AttributeLocation::Normal}}));
+  // Levels are rebuilt as a whole, edits then update rows in place.
+  auto vbo = std::make_unique<ENDER::VertexBuffer>(std::move(layout),
+                                                   ENDER::BufferUsage::Stream);
+  if (onGpu) {
+    GpuSurfaceEvaluator::evaluate(gpuSurface, lod.us, lod.vs, *vbo);
+    lod.gpuBuffer = vbo.get();
+  } else if (!lod.compact)
+    vbo->setData(vertices.data(), sizeof(float) * vertices.size());
+
+  auto ibo = std::make_unique<ENDER::IndexBuffer>(indices.data(),
+                                                  indices.size());
+
+  lod.vertexArray = std::make_shared<ENDER::VertexArray>();
+  lod.vertexArray->addVBO(std::move(vbo));
+  lod.vertexArray->setIndexBuffer(std::move(ibo));
+  if (lod.compact)
+    _quantize(lod);
+  return lod;
+}
+
+void Surface::_quantize(SurfaceLod &lod) {
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{std::numeric_limits<float>::lowest()};
+  for (uint i = 0; i < lod.vertices.size(); i += SURFACE_VERTEX_SIZE) {
+    glm::vec3 vertice{lod.vertices[i], lod.vertices[i + 1],
+                      lod.vertices[i + 2]};
+    min = glm::min(min, vertice);
+    max = glm::max(max, vertice);
+  }
+  // Flat surfaces still need a nonzero extent along their normal.
+  lod.quantMin = min;
+  lod.quantExtent = glm::max(max - min, glm::vec3(1e-6f));
+  lod.vertexArray->setPositionTransform(
+      glm::scale(glm::translate(glm::mat4(1.0f), lod.quantMin),
+                 lod.quantExtent));
+
+  auto packed =
+      _packVertices(lod, 0, lod.vertices.size() / SURFACE_VERTEX_SIZE);
+  lod.vertexArray->setVBOdata(0, packed.data(),
+                              packed.size() * sizeof(uint32_t));
+}
+
+std::pmr::vector<uint32_t> Surface::_packVertices(const SurfaceLod &lod,
+                                                  uint first,
+                                                  uint count) const {
+  std::pmr::vector<uint32_t> packed(&ENDER::FrameArena::local());
+  packed.reserve(count * SURFACE_COMPACT_VERTEX_WORDS);
+  for (uint k = first; k < first + count; k++) {
+    auto vertex = &lod.vertices[k * SURFACE_VERTEX_SIZE];
+    auto position =
+        (glm::vec3{vertex[0], vertex[1], vertex[2]} - lod.quantMin) /
+        lod.quantExtent;
+    packed.push_back(glm::packUnorm2x16({position.x, position.y}));
+    packed.push_back(glm::packUnorm2x16({position.z, 0.0f}));
+    packed.push_back(
+        glm::packSnorm3x10_1x2({vertex[3], vertex[4], vertex[5], 0.0f}));
+  }
+  return packed;
+}
+
+void Surface::_uploadVertices(SurfaceLod &lod, uint first, uint count) {
+  if (lod.mesh != nullptr) {
+    lod.mesh->setVertices(first, &lod.vertices[first * SURFACE_VERTEX_SIZE],
+                          count);
+    return;
+  }
+  if (!lod.compact) {
+    lod.vertexArray->setVBOsubData(
+        0, first * SURFACE_VERTEX_SIZE * sizeof(float),
+        &lod.vertices[first * SURFACE_VERTEX_SIZE],
+        count * SURFACE_VERTEX_SIZE * sizeof(float));
+    return;
+  }
+  auto packed = _packVertices(lod, first, count);
+  lod.vertexArray->setVBOsubData(
+      0, first * SURFACE_COMPACT_VERTEX_WORDS * sizeof(uint32_t),
+      packed.data(), packed.size() * sizeof(uint32_t));
+}
+
+void Surface::_estimateBounds() {
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{std::numeric_limits<float>::lowest()};
+  for (auto v : _uniformParams(_vMin, _vMax, SURFACE_REFINE_PROBES))
+    for (auto u : _uniformParams(_uMin, _uMax, SURFACE_REFINE_PROBES)) {
+      auto point = pointOnSurface(u, v);
+      min = glm::min(min, point);
+      max = glm::max(max, point);
+    }
+  _boundsCenter = (min + max) * 0.5f;
+  _boundsRadius = glm::length(max - min) * 0.5f;
+}
+
+sptr<ENDER::VertexArray> Surface::_getLod(uint level) {
+  if (_lods[level].vertexArray != nullptr)
+    return _lods[level].vertexArray;
+  ENDER::FrameArenaScope scratch;
+
+  if (_adaptive) {
+    // Coarser levels accept proportionally larger deviation.
+    float tolerance = _tolerance * (1 << level);
+    // The level is not built yet, so these are its nominal sizes.
+    auto us = _adaptiveParams(true, getLodCols(level) - 1, tolerance);
+    auto vs = _adaptiveParams(false, getLodRows(level) - 1, tolerance);
+    _lods[level] = _tessellate(std::move(us), std::move(vs));
+  } else
+    _lods[level] =
+        _tessellate(_uniformParams(_uMin, _uMax, getLodCols(level)),
+                    _uniformParams(_vMin, _vMax, getLodRows(level)));
+  return _lods[level].vertexArray;
+}
+
+bool Surface::_uploadPatches() {
+  GpuSurface gpuSurface;
+  bool drawingPatches = _hardwareTessellation &&
+                        GpuSurfaceEvaluator::getPatchShader() != nullptr &&
+                        _getGpuSurface(gpuSurface);
+  if (!drawingPatches) {
+    if (_drawingPatches)
+      setShader(nullptr);
+    _drawingPatches = false;
+    return false;
+  }
+
+  _drawingPatches = true;
+  ENDER::GpuMemory::OwnerScope owner(_name);
+  _patches.upload(gpuSurface, {_uMin, _uMax}, {_vMin, _vMax});
+  setShader(GpuSurfaceEvaluator::getPatchShader());
+  setVertexArray(_patches.getVertexArray());
+  return true;
+}
+
+void Surface::invalidate() {
+  _lods.assign(SURFACE_LOD_COUNT, {});
+  if (_uploadPatches())
+    return;
+  setVertexArray(_getLod(_currentLod));
+}
+
+void Surface::invalidateRegion(bool alongU, float from, float to) {
+  ENDER::FrameArenaScope scratch;
+  // Patches only hold the control net, re-uploading it is all there is.
+  if (_drawingPatches) {
+    if (!_uploadPatches())
+      invalidate();
+    return;
+  }
+
+  auto &lod = _lods[_currentLod];
+  if (lod.vertexArray == nullptr) {
+    invalidate();
+    return;
+  }
+
+  // Other levels are rebuilt from scratch when they are needed again.
+  for (uint level = 0; level < SURFACE_LOD_COUNT; level++)
+    if (level != _currentLod)
+      _lods[level] = {};
+
+  // A dispatch over the whole grid is cheaper than finding the region.
+  if (lod.gpuBuffer != nullptr) {
+    GpuSurface gpuSurface;
+    if (!_getGpuSurface(gpuSurface) ||
+        !GpuSurfaceEvaluator::evaluate(gpuSurface, lod.us, lod.vs,
+                                       *lod.gpuBuffer)) {
+      invalidate();
+      return;
+    }
+    _estimateBounds();
+    return;
+  }
+
+  // The grid itself is kept, only vertex positions are refreshed.
+  auto &params = alongU ? lod.us : lod.vs;
+  uint first = std::lower_bound(params.begin(), params.end(), from) -
+               params.begin();
+  uint last =
+      std::upper_bound(params.begin(), params.end(), to) - params.begin();
+  if (first >= last)
+    return;
+
+  uint rows = lod.vs.size();
+  uint cols = lod.us.size();
+
+  // Set when a vertex left the quantization box of a compact level.
+  bool outside = false;
+  auto growBounds = [&](uint first, uint count) {
+    for (uint k = first; k < first + count; k++) {
+      auto vertex = &lod.vertices[k * SURFACE_VERTEX_SIZE];
+      glm::vec3 vertice{vertex[0], vertex[1], vertex[2]};
+      _boundsRadius =
+          glm::max(_boundsRadius, glm::length(vertice - _boundsCenter));
+      auto q = (vertice - lod.quantMin) / lod.quantExtent;
+      if (lod.compact && (q.x < 0.0f || q.y < 0.0f || q.z < 0.0f ||
+                          q.x > 1.0f || q.y > 1.0f || q.z > 1.0f))
+        outside = true;
+    }
   };
 
+  if (alongU) {
+    _evaluateGrid(lod, 0, rows, first, last);
+    for (uint i = 0; i < rows; i++)
+      growBounds(first + i * cols, last - first);
+  } else {
+    _evaluateGrid(lod, first, last, 0, cols);
+    growBounds(first * cols, (last - first) * cols);
+  }
+
+  if (outside) {
+    _quantize(lod);
+    return;
+  }
+
+  if (alongU) {
+    // Changed columns are contiguous inside every row.
+    for (uint i = 0; i < rows; i++)
+      _uploadVertices(lod, first + i * cols, last - first);
+  } else
+    _uploadVertices(lod, first * cols, (last - first) * cols);
 }
+
+uint Surface::_selectLod(const ENDER::Camera &camera) const {
+  if (_forcedLod >= 0)
+    return _forcedLod;
+
+  auto model = getTransform();
+  auto scale = getScale();
+  float radius =
+      _boundsRadius * std::max({glm::abs(scale.x), glm::abs(scale.y),
+                                glm::abs(scale.z)});
+  auto projection = camera.getProjection();
+  auto clip = projection * camera.getView() * model *
+              glm::vec4(_boundsCenter, 1.0f);
+
+  // An orthographic projection keeps w at 1, the projected size follows from
+  // its extent alone.
+  bool orthographic = projection[2][3] == 0.0f;
+
+  // Camera is inside the bounding sphere.
+  if (!orthographic && clip.w <= radius)
+    return 0;
+
+  float distance = orthographic ? 1.0f : clip.w;
+  float projectedSize = radius * glm::abs(projection[1][1]) / distance *
+                        camera.getFramebufferSize().y;
+  float neededCells = projectedSize / SURFACE_LOD_PIXELS_PER_CELL;
+
+  // Built levels are judged by their actual grids.
+  auto levelFor = [&](float cells) {
+    uint level = 0;
+    while (level + 1 < SURFACE_LOD_COUNT &&
+           getLodCols(level + 1) - 1 >= cells &&
+           getLodRows(level + 1) - 1 >= cells)
+      level++;
+    return level;
+  };
+
+  auto finer = levelFor(neededCells);
+  if (finer < _currentLod)
+    return finer;
+
+  auto coarser = levelFor(neededCells * SURFACE_LOD_HYSTERESIS);
+  if (coarser > _currentLod)
+    return coarser;
+
+  return _currentLod;
+}
+
+void Surface::prepareForRender(const ENDER::Camera &camera) {
+  _flushChanges();
+  if (_drawingPatches) {
+    _viewportSize = camera.getFramebufferSize();
+    return;
+  }
+
+  auto level = _selectLod(camera);
+  if (level == _currentLod && getVertexArray() != nullptr)
+    return;
+  _currentLod = level;
+  setVertexArray(_getLod(_currentLod));
+}
+
+void Surface::bindShaderResources(ENDER::Shader &shader) {
+  if (!_drawingPatches)
+    return;
+  // The renderer sets material colours only for its own shaders.
+  shader.setVec3("material.diffuse", material.diffuse);
+  shader.setVec3("material.ambient", material.ambient);
+  _patches.bind(shader, _viewportSize, SURFACE_LOD_PIXELS_PER_CELL);
+}
+
+const ENDER::PooledMesh *Surface::getPooledMesh() {
+  // Not tessellated yet, or not at this level.
+  if (_drawingPatches || _currentLod >= _lods.size())
+    return nullptr;
+  return _lods[_currentLod].mesh.get();
+}
+
+sptr<ENDER::VertexArray>
+Surface::getTriangleFallback(const ENDER::PooledMesh *&mesh) {
+  if (!_drawingPatches)
+    return nullptr;
+  // Built on the first such pass and kept until the surface changes.
+  auto vertexArray = _getLod(_currentLod);
+  mesh = _lods[_currentLod].mesh.get();
+  return vertexArray;
+}
+
+sptr<ENDER::Shader> Surface::getPickingShader() {
+  return _drawingPatches ? GpuSurfaceEvaluator::getPatchShader(true) : nullptr;
+}
+
+void Surface::drawProperties() {
+  ENDER::Object::drawProperties();
+  if (ImGui::TreeNode("Level of Detail")) {
+    std::vector<std::string> labels = {"Auto"};
+    for (uint level = 0; level < SURFACE_LOD_COUNT; level++) {
+      // Unbuilt adaptive levels show the most they may hold.
+      bool bound = _adaptive && _lods[level].us.empty();
+      labels.push_back((bound ? "<=" : "") + std::to_string(getLodCols(level)) +
+                       "x" + std::to_string(getLodRows(level)));
+    }
+    std::vector<const char *> items;
+    for (auto &label : labels)
+      items.push_back(label.c_str());
+
+    int currentItem = _forcedLod + 1;
+    if (ImGui::Combo("Level", &currentItem, &items[0], items.size()))
+      _forcedLod = currentItem - 1;
+
+    if (ImGui::Checkbox("Adaptive", &_adaptive))
+      markDirty();
+    if (ImGui::Checkbox("Compact Vertices", &_compactVertices))
+      markDirty();
+    if (ENDER::Renderer::getMeshPool() != nullptr &&
+        ImGui::Checkbox("Mesh Pool", &_useMeshPool))
+      markDirty();
+    GpuSurface gpuSurface;
+    if (GpuSurfaceEvaluator::getBackend() !=
+            GpuSurfaceEvaluator::Backend::None &&
+        _getGpuSurface(gpuSurface) &&
+        ImGui::Checkbox("GPU Tessellation", &_gpuTessellation))
+      markDirty();
+    if (GpuSurfaceEvaluator::getPatchShader() != nullptr &&
+        _getGpuSurface(gpuSurface) &&
+        ImGui::Checkbox("Hardware Tessellation", &_hardwareTessellation))
+      markDirty();
+    if (_adaptive) {
+      float tolerance = _tolerance;
+      if (ImGui::DragFloat("Tolerance", &tolerance, 0.0001f, 0.0001f, 1.0f,
+                           "%.4f"))
+        setTolerance(glm::max(tolerance, 0.0001f));
+    }
+
+    if (_drawingPatches)
+      ImGui::Text("Patches: %d", _patches.getPatchCount());
+    else {
+      ImGui::Text("Current level: %d", _currentLod);
+      ImGui::Text("Triangles: %d", getVertexArray() != nullptr
+                                       ? getVertexArray()->indexCount() / 3
+                                       : 0);
+    }
+    ImGui::TreePop();
+  }
+}
+
+} // namespace EGEOM
@@ -1,10 +1,12 @@
 #include "glm/fwd.hpp"
 #include "spdlog/spdlog.h"
+#include <FrameArena.hpp>
 #include <Utils.hpp>
+#include <algorithm>
 
 namespace EGEOM {
 
-int bSplineFindSpan(int n, int p, float u, std::vector<float> U) {
+int bSplineFindSpan(int n, int p, float u, const std::vector<float> &U) {
   if (u == U[n + 1]) {
     return n;
   }
@@ -32,11 +34,12 @@ int binomialCoeff(int n, int k) {
   return binomialCoeff(n - 1, k - 1) + binomialCoeff(n - 1, k);
 }
 
-std::vector<float> bSplineBasisFunc(int i, float u, int p,
-                                    std::vector<float> U) {
-  std::vector<float> N(p + 1, 0);
-  std::vector<float> left(p + 1, 0);
-  std::vector<float> right(p + 1, 0);
+std::pmr::vector<float> bSplineBasisFunc(int i, float u, int p,
+                                         const std::vector<float> &U) {
+  auto arena = &ENDER::FrameArena::local();
+  std::pmr::vector<float> N(p + 1, 0, arena);
+  std::pmr::vector<float> left(p + 1, 0, arena);
+  std::pmr::vector<float> right(p + 1, 0, arena);
 
   N[0] = 1.0f;
   for (int j = 1; j <= p; j++) {
@@ -54,12 +57,13 @@ std::vector<float> bSplineBasisFunc(int i, float u, int p,
 }
 
 Matrix<float> dersBasisFunc(int i, float u, int p, int n,
-                            std::vector<float> U) {
-  Matrix<float> ders(n + 1, p + 1);
-  Matrix<float> ndu(p + 1, p + 1);
-  std::vector<float> left(p + 1, 0);
-  std::vector<float> right(p + 1, 0);
-  Matrix<float> a(2, p + 1);
+                            const std::vector<float> &U) {
+  auto arena = &ENDER::FrameArena::local();
+  Matrix<float> ders(n + 1, p + 1, arena);
+  Matrix<float> ndu(p + 1, p + 1, arena);
+  std::pmr::vector<float> left(p + 1, 0, arena);
+  std::pmr::vector<float> right(p + 1, 0, arena);
+  Matrix<float> a(2, p + 1, arena);
   ndu[0][0] = 1.0f;
   for (auto j = 1; j <= p; j++) {
     left[j] = u - U[i + 1 - j];
@@ -113,4 +117,43 @@ Matrix<float> dersBasisFunc(int i, float u, int p, int n,
   }
   return ders;
 }
+
+const BasisTable &BasisTableCache::get(uint64_t knotVersion, int degree,
+                                       int derivatives,
+                                       const std::vector<float> &params, int n,
+                                       const std::vector<float> &U) {
+  for (auto it = _tables.begin(); it != _tables.end(); it++) {
+    if (it->knotVersion != knotVersion || it->degree != degree ||
+        it->derivatives < derivatives || it->params != params)
+      continue;
+    if (it + 1 != _tables.end())
+      std::rotate(it, it + 1, _tables.end());
+    return _tables.back();
+  }
+
+  if (_tables.size() == BASIS_TABLE_CACHE_SIZE)
+    _tables.erase(_tables.begin());
+
+  BasisTable table;
+  table.knotVersion = knotVersion;
+  table.degree = degree;
+  table.derivatives = derivatives;
+  table.params = params;
+  table.spans.reserve(params.size());
+  table.weights.reserve(params.size() * (derivatives + 1) * (degree + 1));
+
+  // Derivatives above the degree are zero.
+  int du = std::min(derivatives, degree);
+  for (auto u : params) {
+    int span = bSplineFindSpan(n, degree, u, U);
+    auto ders = dersBasisFunc(span, u, degree, du, U);
+    table.spans.push_back(span);
+    for (auto k = 0; k <= derivatives; k++)
+      for (auto j = 0; j <= degree; j++)
+        table.weights.push_back(k <= du ? ders[k][j] : 0.0f);
+  }
+
+  _tables.push_back(std::move(table));
+  return _tables.back();
+}
 } // namespace EGEOM
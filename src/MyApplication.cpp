@@ -3,6 +3,7 @@
 #include "IconsFontAwesome5.h"
 #include "ImGuizmo.h"
 #include "KinematicSurfaces.hpp"
+#include "NurbsSurface.hpp"
 #include "Point.hpp"
 #include "Renderer.hpp"
 #include "RotationSurface.hpp"
@@ -26,6 +27,9 @@ MyApplication::MyApplication(uint appWidth, uint appHeight)
 void MyApplication::onStart() {
   bool darkTheme = false;
 
+  // An idle editor draws nothing.
+  ENDER::Window::setRedrawOnDemand(true);
+
   if (darkTheme) {
     ENDER::Renderer::setClearColor({0.093f, 0.093f, 0.093f, 1.0f});
     ENDER::Utils::applyImguiTheme();
@@ -233,9 +237,12 @@ void MyApplication::handleViewportGUI() {
     }
   }
 
+  // The image takes only the bottom left part of the texture.
+  auto viewportScale = viewportFramebuffer->getTextureScale();
   ImGui::Image(
       reinterpret_cast<ImTextureID>(viewportFramebuffer->getTextureId()),
-      ImGui::GetContentRegionAvail(), ImVec2(0, 1), ImVec2(1, 0));
+      ImGui::GetContentRegionAvail(), ImVec2(0, viewportScale.y),
+      ImVec2(viewportScale.x, 0));
   if (selectedObjectViewport) {
 
     ImGuizmo::SetOrthographic(false);
@@ -376,6 +383,29 @@ void MyApplication::handleViewportGUI() {
 void MyApplication::handleDebugGUI() {
   ImGui::Begin("Debug");
   ImGui::Text("FPS: %.2f", 1.0f / ENDER::Window::deltaTime());
+  bool redrawOnDemand = ENDER::Window::isRedrawOnDemand();
+  if (ImGui::Checkbox("Redraw on demand", &redrawOnDemand))
+    ENDER::Window::setRedrawOnDemand(redrawOnDemand);
+
+  auto arenaStats = ENDER::FrameArena::local().lastFrameStats();
+  ImGui::Text("Frame arena: peak %.1f / %.1f KB, blocks allocated: %d",
+              arenaStats.peakBytesUsed / 1024.0f,
+              arenaStats.bytesReserved / 1024.0f, arenaStats.blockAllocations);
+#ifdef ENDER_COUNT_HEAP_ALLOCATIONS
+  ImGui::Text("Heap allocations last frame: %zu", arenaStats.heapAllocations);
+#endif
+
+  if (ImGui::CollapsingHeader("GPU Memory"))
+    ENDER::GpuMemory::drawPanel();
+
+  std::vector<const char *> evaluators = {"CPU only", "Compute shader",
+                                          "Transform feedback"};
+  int currentEvaluator =
+      static_cast<int>(EGEOM::GpuSurfaceEvaluator::getBackend());
+  if (ImGui::Combo("Surface evaluator", &currentEvaluator, &evaluators[0],
+                   evaluators.size()))
+    EGEOM::GpuSurfaceEvaluator::setBackend(
+        static_cast<EGEOM::GpuSurfaceEvaluator::Backend>(currentEvaluator));
 
   if (ImGui::SliderInt("Interpolation Points Count", &interpolationPointsCount,
                        2, 300)) {
@@ -412,8 +442,10 @@ void MyApplication::handleSketchGUI() {
 
   sketchWindowPos = ImGui::GetCursorScreenPos();
 
+  auto sketchScale = sketchFramebuffer->getTextureScale();
   ImGui::Image(reinterpret_cast<ImTextureID>(sketchFramebuffer->getTextureId()),
-               ImGui::GetContentRegionAvail(), ImVec2(0, 1), ImVec2(1, 0));
+               ImGui::GetContentRegionAvail(), ImVec2(0, sketchScale.y),
+               ImVec2(sketchScale.x, 0));
 
   ImGui::End();
 }
@@ -425,6 +457,11 @@ void MyApplication::handleMenuBarGUI() {
         close();
       ImGui::EndMenu();
     }
+    if (ImGui::BeginMenu("Create")) {
+      if (ImGui::MenuItem("NURBS Surface"))
+        createNurbsSurface();
+      ImGui::EndMenu();
+    }
     ImGui::EndMenuBar();
   }
 }
@@ -598,26 +635,35 @@ void MyApplication::onGUI() {
 void MyApplication::update(float deltaTime) { viewportCamera->proccessInput(); }
 
 void MyApplication::render() {
-  ENDER::Renderer::renderScene(viewportScene, viewportFramebuffer);
-  ENDER::Renderer::renderScene(sketchScene, sketchFramebuffer);
-
-  if (currentSketchId == -1)
-    return;
-
-  if (renderDebugSplinePoints)
-    for (auto p :
-         sketches[currentSketchId]->getSpline()->getInterpolatedPoints()) {
-      p->material.ambient = {0.0, 0.6, 0.6};
-      p->material.diffuse = {0.0, 0.6, 0.6};
-
-      ENDER::Renderer::renderObject(p, sketchScene, sketchFramebuffer);
-    }
+  // Each panel is drawn again only when something it shows has changed.
+  auto viewportVersion = ENDER::Renderer::contentVersion(viewportScene);
+  if (viewportFramebuffer->needsRender(viewportVersion)) {
+    ENDER::Renderer::renderScene(viewportScene, viewportFramebuffer);
+    viewportFramebuffer->setContentVersion(viewportVersion);
+  }
 
-  for (auto p : sketches[currentSketchId]->getSpline()->getPoints()) {
-    ENDER::Renderer::renderObject(p, sketchScene, sketchFramebuffer);
+  std::vector<sptr<ENDER::Object>> sketchObjects;
+  if (currentSketchId != -1) {
+    auto spline = sketches[currentSketchId]->getSpline();
+    if (renderDebugSplinePoints)
+      for (auto p : spline->getInterpolatedPoints()) {
+        p->material.ambient = {0.0, 0.6, 0.6};
+        p->material.diffuse = {0.0, 0.6, 0.6};
+        sketchObjects.push_back(p);
+      }
+    for (auto p : spline->getPoints())
+      sketchObjects.push_back(p);
+    sketchObjects.push_back(spline);
   }
-  ENDER::Renderer::renderObject(sketches[currentSketchId]->getSpline(),
-                                sketchScene, sketchFramebuffer);
+
+  auto sketchVersion =
+      ENDER::Renderer::contentVersion(sketchScene, sketchObjects);
+  if (!sketchFramebuffer->needsRender(sketchVersion))
+    return;
+  ENDER::Renderer::renderScene(sketchScene, sketchFramebuffer);
+  for (auto &object : sketchObjects)
+    ENDER::Renderer::renderObject(object, sketchScene, sketchFramebuffer);
+  sketchFramebuffer->setContentVersion(sketchVersion);
 }
 
 void MyApplication::onKey(int key, ENDER::Window::EventStatus status) {}
@@ -629,7 +675,7 @@ void MyApplication::onMouseClick(ENDER::Window::MouseButton button,
   if (button == ENDER::Window::MouseButton::Left &&
       status == ENDER::Window::EventStatus::Release) {
     mouseMove = false;
-    selectedObjectSketch = nullptr;
+    resetSketchSelection();
   }
   if (button == ENDER::Window::MouseButton::Left &&
       status == ENDER::Window::EventStatus::Press) {
@@ -670,6 +716,13 @@ void MyApplication::onMouseClick(ENDER::Window::MouseButton button,
         if (currentSelected) {
           selectedObjectSketch = currentSelected;
           justSelected = true;
+          // Point used several times in the curve has no single index.
+          auto points = sketches[currentSketchId]->getSpline()->getPoints();
+          auto it = std::find(points.begin(), points.end(), currentSelected);
+          selectedPointIndexSketch =
+              std::count(points.begin(), points.end(), currentSelected) == 1
+                  ? it - points.begin()
+                  : -1;
           for (auto object :
                sketches[currentSketchId]->getSpline()->getPoints())
             object->setSelected(false);
@@ -785,6 +838,11 @@ void MyApplication::onKeyPress(int key) {
 
 void MyApplication::onClose() {}
 
+void MyApplication::resetSketchSelection() {
+  selectedObjectSketch = nullptr;
+  selectedPointIndexSketch = -1;
+}
+
 void MyApplication::onMouseMove(uint x, uint y) {
   if (ENDER::Window::isMouseButtonPressed(ENDER::Window::MouseButton::Left)) {
     if (currentTool == Tools::Cursor && selectedObjectSketch != nullptr &&
@@ -801,7 +859,17 @@ void MyApplication::onMouseMove(uint x, uint y) {
           {mouseScreenPosX, mouseScreenPosY});
 
       selectedObjectSketch->setPosition({worldPos.x, 0, worldPos.y});
-      sketches[currentSketchId]->getSpline()->update();
+      auto spline = sketches[currentSketchId]->getSpline();
+      // Points may have been replaced since the point was picked.
+      auto points = spline->getPoints();
+      if (selectedPointIndexSketch >= (int)points.size() ||
+          (selectedPointIndexSketch >= 0 &&
+           points[selectedPointIndexSketch] != selectedObjectSketch))
+        selectedPointIndexSketch = -1;
+      if (selectedPointIndexSketch >= 0)
+        spline->updatePoint(selectedPointIndexSketch);
+      else
+        spline->update();
     }
   }
 }
@@ -841,6 +909,7 @@ void MyApplication::handleSketchSideGUI() {
         "Sketch " + std::to_string(sketches.size()), spline);
     sketches.push_back(newSketch);
     currentSketchId = sketches.size() - 1;
+    resetSketchSelection();
   }
 
   if (ImGui::Button("Save sketch")) {
@@ -988,6 +1057,7 @@ void MyApplication::handleSketchSideGUI() {
           "Sketch " + std::to_string(sketches.size()), spline);
       sketches.push_back(newSketch);
       currentSketchId = sketches.size() - 1;
+      resetSketchSelection();
 
       // action
     }
@@ -1001,8 +1071,9 @@ void MyApplication::handleSketchSideGUI() {
                 [&sketchesNameList](auto sketch) {
                   sketchesNameList.push_back(sketch->name.c_str());
                 });
-  ImGui::ListBox("Sketches List", &currentSketchId, &sketchesNameList[0],
-                 sketchesNameList.size(), 4);
+  if (ImGui::ListBox("Sketches List", &currentSketchId, &sketchesNameList[0],
+                     sketchesNameList.size(), 4))
+    resetSketchSelection();
 
   ImGui::End();
 }
@@ -1037,6 +1108,23 @@ void MyApplication::createPivotPlane() {
   viewportScene->addObject(pivotPlane);
 }
 
+void MyApplication::createNurbsSurface() {
+  // Bicubic 5x5 patch with a bump in the middle.
+  const uint count = 5;
+  std::vector<glm::vec3> controlPoints;
+  for (uint i = 0; i < count; i++)
+    for (uint j = 0; j < count; j++) {
+      float height = (i == 2 && j == 2) ? 3.0f : 0.0f;
+      controlPoints.push_back({i * 2.0f, height, j * 2.0f});
+    }
+
+  auto surface = EGEOM::NurbsSurface::create(
+      "NURBS Surface " + std::to_string(viewportScene->getObjects().size()),
+      controlPoints, count, count, 3, 3);
+  surface->isSelectable = true;
+  viewportScene->addObject(surface);
+}
+
 void MyApplication::handlePropertiesGUI() {
   ImGui::Begin("Properties");
   if (activeWindow == Windows::Viewport) {
@@ -49,6 +49,7 @@ class MyApplication : public ENDER::Application {
 
   sptr<ENDER::Object> selectedObjectViewport;
   sptr<ENDER::Object> selectedObjectSketch;
+  int selectedPointIndexSketch = -1;
 
   ImGuizmo::OPERATION currentOperation = ImGuizmo::OPERATION::TRANSLATE;
 
@@ -93,6 +94,10 @@ public:
   void handleDimensionalSplinesGUI();
 
   void createPivotPlane();
+  void createNurbsSurface();
+
+  // Forgets the dragged sketch point, e.g. when another sketch is selected.
+  void resetSketchSelection();
 
   void beginDockspace();
 
@@ -70,6 +70,10 @@ bool ENDER::FirstPersonCamera::getSpotlightToggled() const {
   return _spotLigthToggled;
 }
 
+glm::vec2 ENDER::FirstPersonCamera::getFramebufferSize() const {
+  return _framebufferSize;
+}
+
 void ENDER::FirstPersonCamera::proccessInput() {
   if(!_isActive)
     return;
@@ -0,0 +1,85 @@
+#include <FrameArena.hpp>
+#include <spdlog/spdlog.h>
+
+ENDER::FrameArena::allocationHook ENDER::FrameArena::_allocationHook;
+
+static thread_local size_t threadHeapAllocations = 0;
+
+void ENDER::FrameArena::countHeapAllocation() { threadHeapAllocations++; }
+
+size_t ENDER::FrameArena::heapAllocations() { return threadHeapAllocations; }
+
+ENDER::FrameArena::FrameArena(size_t blockSize) {
+  _addBlock(blockSize);
+  _frameHeapAllocations = heapAllocations();
+}
+
+void ENDER::FrameArena::_addBlock(size_t size) {
+  _blocks.push_back({std::make_unique<std::byte[]>(size), size});
+  _stats.bytesReserved += size;
+  _stats.blockAllocations++;
+  if (_allocationHook)
+    _allocationHook(size);
+}
+
+void *ENDER::FrameArena::do_allocate(size_t bytes, size_t alignment) {
+  while (true) {
+    auto &block = _blocks[_currentBlock];
+    auto address = reinterpret_cast<uintptr_t>(block.data.get()) + _offset;
+    size_t padding = (alignment - address % alignment) % alignment;
+
+    if (_offset + padding + bytes <= block.size) {
+      _offset += padding + bytes;
+      _stats.bytesUsed += padding + bytes;
+      _stats.peakBytesUsed = std::max(_stats.peakBytesUsed, _stats.bytesUsed);
+      return block.data.get() + _offset - bytes;
+    }
+
+    if (_currentBlock + 1 == _blocks.size())
+      _addBlock(std::max(block.size, bytes + alignment));
+    _currentBlock++;
+    _offset = 0;
+  }
+}
+
+ENDER::FrameArena::Marker ENDER::FrameArena::mark() const {
+  return {_currentBlock, _offset, _stats.bytesUsed};
+}
+
+void ENDER::FrameArena::rewind(const Marker &marker) {
+  _currentBlock = marker.block;
+  _offset = marker.offset;
+  _stats.bytesUsed = marker.bytesUsed;
+}
+
+void ENDER::FrameArena::reset() {
+  if (_blocks.size() > 1) {
+    size_t size = 0;
+    for (auto &block : _blocks)
+      size += block.size;
+    size = std::min(size, FRAME_ARENA_MAX_RETAINED_SIZE);
+    spdlog::debug("FrameArena: frame peaked at {} bytes in {} blocks, keeping "
+                  "{} bytes",
+                  _stats.peakBytesUsed, _blocks.size(), size);
+    _blocks.clear();
+    _stats.bytesReserved = 0;
+    _addBlock(size);
+  }
+
+  _stats.heapAllocations = heapAllocations() - _frameHeapAllocations;
+  _lastFrameStats = _stats;
+  _stats = {};
+  _stats.bytesReserved = _blocks[0].size;
+  _currentBlock = 0;
+  _offset = 0;
+  _frameHeapAllocations = heapAllocations();
+}
+
+ENDER::FrameArena &ENDER::FrameArena::local() {
+  thread_local FrameArena arena;
+  return arena;
+}
+
+void ENDER::FrameArena::setAllocationHook(allocationHook hook) {
+  _allocationHook = hook;
+}
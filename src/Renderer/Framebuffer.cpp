@@ -1,17 +1,23 @@
 #include "PickingTexture.hpp"
 #include <Framebuffer.hpp>
+#include <GpuMemory.hpp>
+#include <algorithm>
+#include <cmath>
 #include <glad/glad.h>
 #include <memory>
 #include <spdlog/spdlog.h>
 
-ENDER::Framebuffer::Framebuffer(float width, float height) {
+ENDER::Framebuffer::Framebuffer(float width, float height)
+    : _width(_pixels(width)), _height(_pixels(height)),
+      _allocatedWidth(_roundSize(width)),
+      _allocatedHeight(_roundSize(height)) {
   glGenFramebuffers(1, &_id);
   glBindFramebuffer(GL_FRAMEBUFFER, _id);
 
   glGenTextures(1, &_tid);
   glBindTexture(GL_TEXTURE_2D, _tid);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB,
-               GL_UNSIGNED_BYTE, NULL);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, _allocatedWidth, _allocatedHeight, 0,
+               GL_RGB, GL_UNSIGNED_BYTE, NULL);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
@@ -19,7 +25,8 @@ ENDER::Framebuffer::Framebuffer(float width, float height) {
 
   glGenRenderbuffers(1, &_rid);
   glBindRenderbuffer(GL_RENDERBUFFER, _rid);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _allocatedWidth,
+                        _allocatedHeight);
   glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
                             GL_RENDERBUFFER, _rid);
 
@@ -30,14 +37,19 @@ ENDER::Framebuffer::Framebuffer(float width, float height) {
   glBindTexture(GL_TEXTURE_2D, 0);
   glBindRenderbuffer(GL_RENDERBUFFER, 0);
 
-  _width = width;
-  _height = height;
+  GpuMemory::add(GpuResourceKind::Framebuffer, _id);
+  GpuMemory::add(GpuResourceKind::Texture, _tid);
+  GpuMemory::add(GpuResourceKind::Renderbuffer, _rid);
+  _trackSizes();
 
   _pickingTexture = PickingTexture::create();
-  _pickingTexture->init(_width, _height);
+  _pickingTexture->init(_allocatedWidth, _allocatedHeight);
 }
 
 ENDER::Framebuffer::~Framebuffer() {
+  GpuMemory::remove(GpuResourceKind::Framebuffer, _id);
+  GpuMemory::remove(GpuResourceKind::Texture, _tid);
+  GpuMemory::remove(GpuResourceKind::Renderbuffer, _rid);
   glDeleteFramebuffers(1, &_id);
   glDeleteTextures(1, &_tid);
   glDeleteRenderbuffers(1, &_rid);
@@ -48,6 +60,9 @@ sptr<ENDER::Framebuffer> ENDER::Framebuffer::create(float width, float height) {
 }
 
 uint ENDER::Framebuffer::pickObjAt(uint x, uint y) {
+  // The image starts at the bottom row of the attachments.
+  if (x >= _width || y >= _height)
+    return 0;
   return _pickingTexture->readPixel(x, _height - y - 1).objectID;
 }
 
@@ -55,32 +70,73 @@ uint ENDER::Framebuffer::getId() { return _id; }
 
 uint ENDER::Framebuffer::getTextureId() { return _tid; }
 
-void ENDER::Framebuffer::bind() { glBindFramebuffer(GL_FRAMEBUFFER, _id); }
+void ENDER::Framebuffer::bind() {
+  glBindFramebuffer(GL_FRAMEBUFFER, _id);
+  // The picking texture is drawn with this viewport as well.
+  glViewport(0, 0, _width, _height);
+}
 
 void ENDER::Framebuffer::unbind() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
 
 void ENDER::Framebuffer::rescale(float width, float height) {
+  // Reallocation discards the image, which can otherwise be shown again.
+  if (_pixels(width) == _width && _pixels(height) == _height)
+    return;
+  _width = _pixels(width);
+  _height = _pixels(height);
+  invalidate();
+
+  auto allocatedWidth = _roundSize(width);
+  auto allocatedHeight = _roundSize(height);
+  bool fits = allocatedWidth <= _allocatedWidth &&
+              allocatedHeight <= _allocatedHeight;
+  bool wasteful = allocatedWidth * 2 < _allocatedWidth ||
+                  allocatedHeight * 2 < _allocatedHeight;
+  if (fits && !wasteful)
+    return;
+  _allocatedWidth = allocatedWidth;
+  _allocatedHeight = allocatedHeight;
+
+  // Both stay attached, re-specifying the storage is enough.
   glBindTexture(GL_TEXTURE_2D, _tid);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB,
-               GL_UNSIGNED_BYTE, NULL);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-                         _tid, 0);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, _allocatedWidth, _allocatedHeight, 0,
+               GL_RGB, GL_UNSIGNED_BYTE, NULL);
+  glBindTexture(GL_TEXTURE_2D, 0);
 
   glBindRenderbuffer(GL_RENDERBUFFER, _rid);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
-                            GL_RENDERBUFFER, _rid);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _allocatedWidth,
+                        _allocatedHeight);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  _trackSizes();
 
-  _width = width;
-  _height = height;
+  _pickingTexture->updateTextureSize(_allocatedWidth, _allocatedHeight);
+}
+
+uint ENDER::Framebuffer::_pixels(float size) {
+  return std::max(1.0f, std::ceil(size));
+}
 
-  _pickingTexture->updateTextureSize(width, height);
+uint ENDER::Framebuffer::_roundSize(float size) {
+  return (_pixels(size) + FRAMEBUFFER_SIZE_STEP - 1) / FRAMEBUFFER_SIZE_STEP *
+         FRAMEBUFFER_SIZE_STEP;
+}
+
+glm::vec2 ENDER::Framebuffer::getTextureScale() const {
+  return {(float)_width / _allocatedWidth, (float)_height / _allocatedHeight};
+}
 
-  glViewport(0, 0, width, height);
+bool ENDER::Framebuffer::needsRender(uint64_t contentVersion) const {
+  return !_contentValid || _contentVersion != contentVersion;
 }
 
+void ENDER::Framebuffer::setContentVersion(uint64_t contentVersion) {
+  _contentVersion = contentVersion;
+  _contentValid = true;
+}
+
+void ENDER::Framebuffer::invalidate() { _contentValid = false; }
+
 void ENDER::Framebuffer::clear() {
   bind();
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -91,6 +147,13 @@ void ENDER::Framebuffer::clear() {
   _pickingTexture->disableWriting();
 }
 
+void ENDER::Framebuffer::_trackSizes() {
+  // RGB8 color is stored padded to 4 bytes, depth-stencil takes 4 as well.
+  size_t pixels = (size_t)_allocatedWidth * _allocatedHeight;
+  GpuMemory::resize(GpuResourceKind::Texture, _tid, pixels * 4);
+  GpuMemory::resize(GpuResourceKind::Renderbuffer, _rid, pixels * 4);
+}
+
 sptr<ENDER::PickingTexture> ENDER::Framebuffer::getPickingTexture() {
   return _pickingTexture;
 }
@@ -0,0 +1,170 @@
+#include <GpuMemory.hpp>
+#include <algorithm>
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+
+std::map<std::pair<ENDER::GpuResourceKind, unsigned int>,
+         ENDER::GpuMemory::Allocation>
+    ENDER::GpuMemory::_allocations;
+uint64_t ENDER::GpuMemory::_frame = 0;
+
+static thread_local std::string currentOwner;
+
+static const ENDER::GpuResourceKind allKinds[] = {
+    ENDER::GpuResourceKind::Buffer, ENDER::GpuResourceKind::Texture,
+    ENDER::GpuResourceKind::Renderbuffer, ENDER::GpuResourceKind::Framebuffer,
+    ENDER::GpuResourceKind::VertexArray};
+
+ENDER::GpuMemory::OwnerScope::OwnerScope(const std::string &owner)
+    : _previous(currentOwner) {
+  currentOwner = owner;
+}
+
+ENDER::GpuMemory::OwnerScope::~OwnerScope() { currentOwner = _previous; }
+
+void ENDER::GpuMemory::add(GpuResourceKind kind, unsigned int id,
+                           size_t bytes) {
+  if (id == 0)
+    return;
+  _allocations[{kind, id}] = {kind, id, bytes, currentOwner, _frame};
+}
+
+void ENDER::GpuMemory::resize(GpuResourceKind kind, unsigned int id,
+                              size_t bytes) {
+  auto it = _allocations.find({kind, id});
+  if (it == _allocations.end()) {
+    add(kind, id, bytes);
+    return;
+  }
+  it->second.bytes = bytes;
+}
+
+void ENDER::GpuMemory::remove(GpuResourceKind kind, unsigned int id) {
+  if (id == 0)
+    return;
+  if (_allocations.erase({kind, id}) == 0)
+    spdlog::warn("GpuMemory: releasing unknown {} {}", kindToString(kind), id);
+}
+
+void ENDER::GpuMemory::move(GpuResourceKind kind, unsigned int from,
+                            unsigned int to, size_t bytes) {
+  auto it = _allocations.find({kind, from});
+  if (it == _allocations.end()) {
+    add(kind, to, bytes);
+    return;
+  }
+  auto allocation = it->second;
+  _allocations.erase(it);
+  allocation.id = to;
+  allocation.bytes = bytes;
+  _allocations[{kind, to}] = allocation;
+}
+
+size_t ENDER::GpuMemory::totalBytes() {
+  size_t total = 0;
+  for (auto &[key, allocation] : _allocations)
+    total += allocation.bytes;
+  return total;
+}
+
+size_t ENDER::GpuMemory::totalBytes(GpuResourceKind kind) {
+  size_t total = 0;
+  for (auto &[key, allocation] : _allocations)
+    if (allocation.kind == kind)
+      total += allocation.bytes;
+  return total;
+}
+
+size_t ENDER::GpuMemory::count(GpuResourceKind kind) {
+  size_t res = 0;
+  for (auto &[key, allocation] : _allocations)
+    if (allocation.kind == kind)
+      res++;
+  return res;
+}
+
+std::vector<ENDER::GpuMemory::Allocation> ENDER::GpuMemory::snapshot() {
+  std::vector<Allocation> res;
+  res.reserve(_allocations.size());
+  for (auto &[key, allocation] : _allocations)
+    res.push_back(allocation);
+  std::stable_sort(res.begin(), res.end(),
+                   [](const Allocation &a, const Allocation &b) {
+                     return a.bytes > b.bytes;
+                   });
+  return res;
+}
+
+void ENDER::GpuMemory::dump() {
+  spdlog::info("GPU memory at frame {}: {:.1f} KB in {} objects", _frame,
+               totalBytes() / 1024.0, _allocations.size());
+  for (auto kind : allKinds)
+    spdlog::info("\t{}: {} objects, {:.1f} KB", kindToString(kind),
+                 count(kind), totalBytes(kind) / 1024.0);
+  for (auto &allocation : snapshot())
+    spdlog::info("\t{} {}: {} bytes, owner: {}, created at frame {}",
+                 kindToString(allocation.kind), allocation.id,
+                 allocation.bytes,
+                 allocation.owner.empty() ? "-" : allocation.owner,
+                 allocation.frame);
+}
+
+void ENDER::GpuMemory::drawPanel() {
+  ImGui::Text("GPU memory: %.1f KB in %d objects", totalBytes() / 1024.0f,
+              (int)_allocations.size());
+  for (auto kind : allKinds)
+    ImGui::BulletText("%s: %d, %.1f KB", kindToString(kind), (int)count(kind),
+                      totalBytes(kind) / 1024.0f);
+
+  if (ImGui::Button("Dump to log"))
+    dump();
+
+  if (!ImGui::TreeNode("Allocations"))
+    return;
+  if (ImGui::BeginTable("GpuAllocations", 5,
+                        ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                            ImGuiTableFlags_Resizable |
+                            ImGuiTableFlags_ScrollY,
+                        ImVec2(0, 300))) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Kind");
+    ImGui::TableSetupColumn("Id");
+    ImGui::TableSetupColumn("KB");
+    ImGui::TableSetupColumn("Owner");
+    ImGui::TableSetupColumn("Frame");
+    ImGui::TableHeadersRow();
+    for (auto &allocation : snapshot()) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", kindToString(allocation.kind));
+      ImGui::TableNextColumn();
+      ImGui::Text("%u", allocation.id);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", allocation.bytes / 1024.0f);
+      ImGui::TableNextColumn();
+      ImGui::Text("%s",
+                  allocation.owner.empty() ? "-" : allocation.owner.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)allocation.frame);
+    }
+    ImGui::EndTable();
+  }
+  ImGui::TreePop();
+}
+
+const char *ENDER::GpuMemory::kindToString(GpuResourceKind kind) {
+  switch (kind) {
+  case GpuResourceKind::Buffer:
+    return "Buffer";
+  case GpuResourceKind::Texture:
+    return "Texture";
+  case GpuResourceKind::Renderbuffer:
+    return "Renderbuffer";
+  case GpuResourceKind::Framebuffer:
+    return "Framebuffer";
+  case GpuResourceKind::VertexArray:
+    return "VertexArray";
+  default:
+    return "Unknown";
+  }
+}
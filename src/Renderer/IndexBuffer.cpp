@@ -1,19 +1,81 @@
 #include <IndexBuffer.hpp>
+#include <algorithm>
 #include <glad/glad.h>
 
-ENDER::IndexBuffer::IndexBuffer(unsigned int *indices, unsigned int count)
+ENDER::IndexBuffer::IndexBuffer(unsigned int *indices, unsigned int count,
+                                BufferUsage usage)
 {
   _count = count;
+  _capacity = count;
+  _usage = usage;
   glGenBuffers(1, &_id);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _id);
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), indices,
-               GL_STATIC_DRAW);
+               convertUsageToGLUsage(usage));
   unbind();
+  GpuMemory::add(GpuResourceKind::Buffer, _id, count * sizeof(unsigned int));
   spdlog::debug("Created IndexBuffer. Index: {}", _id);
 }
 
+void ENDER::IndexBuffer::setData(unsigned int *indices, unsigned int count)
+{
+  _count = count;
+  // Binding to GL_ELEMENT_ARRAY_BUFFER would attach it to whatever vertex
+  // array is bound.
+  glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+  if (_usage != BufferUsage::Static && count <= _capacity)
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, count * sizeof(unsigned int),
+                    indices);
+  else
+  {
+    _capacity = _usage == BufferUsage::Static ? count : std::max(count, _capacity * 2);
+    glBufferData(GL_COPY_WRITE_BUFFER, _capacity * sizeof(unsigned int),
+                 nullptr, convertUsageToGLUsage(_usage));
+    GpuMemory::resize(GpuResourceKind::Buffer, _id,
+                      _capacity * sizeof(unsigned int));
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, count * sizeof(unsigned int),
+                    indices);
+  }
+}
+
+void ENDER::IndexBuffer::setSubData(unsigned int first,
+                                    const unsigned int *indices,
+                                    unsigned int count)
+{
+  glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, first * sizeof(unsigned int),
+                  count * sizeof(unsigned int), indices);
+}
+
+void ENDER::IndexBuffer::resize(unsigned int count)
+{
+  if (count > _capacity)
+  {
+    auto capacity = std::max(count, _capacity * 2);
+    // Data goes through a temporary buffer while the storage is reallocated.
+    unsigned int temp;
+    glGenBuffers(1, &temp);
+    glBindBuffer(GL_COPY_READ_BUFFER, temp);
+    glBufferData(GL_COPY_READ_BUFFER, _count * sizeof(unsigned int), nullptr,
+                 GL_STREAM_COPY);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+    glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_COPY_READ_BUFFER, 0, 0,
+                        _count * sizeof(unsigned int));
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * sizeof(unsigned int),
+                 nullptr, convertUsageToGLUsage(_usage));
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                        _count * sizeof(unsigned int));
+    glDeleteBuffers(1, &temp);
+    _capacity = capacity;
+    GpuMemory::resize(GpuResourceKind::Buffer, _id,
+                      _capacity * sizeof(unsigned int));
+  }
+  _count = count;
+}
+
 ENDER::IndexBuffer::~IndexBuffer()
 {
+  GpuMemory::remove(GpuResourceKind::Buffer, _id);
   glDeleteBuffers(1, &_id);
   spdlog::info("Deallocated IndexBuffer[Index: {}]", _id);
 }
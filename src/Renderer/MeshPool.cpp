@@ -0,0 +1,153 @@
+#include <MeshPool.hpp>
+#include <algorithm>
+#include <numeric>
+
+ENDER::PooledMesh::~PooledMesh() {
+  auto pool = _pool.lock();
+  if (!pool)
+    return;
+  MeshPool::_free(pool->_freeVertices, baseVertex, vertexCount);
+  MeshPool::_free(pool->_freeIndices, firstIndex, indexCount);
+}
+
+void ENDER::PooledMesh::setVertices(uint first, const float *vertices,
+                                    uint count) {
+  auto pool = _pool.lock();
+  if (!pool)
+    return;
+  auto stride = MESH_POOL_VERTEX_SIZE * sizeof(float);
+  pool->_vertexArray->setVBOsubData(0, (baseVertex + first) * stride, vertices,
+                                    count * stride);
+}
+
+void ENDER::PooledMesh::setIndices(const unsigned int *indices) {
+  auto pool = _pool.lock();
+  if (!pool)
+    return;
+  pool->_vertexArray->setIndexSubData(firstIndex, indices, indexCount);
+}
+
+ENDER::MeshPool::MeshPool() {
+  GpuMemory::OwnerScope owner("MeshPool");
+  _vertexArray = std::make_shared<VertexArray>();
+  _vertexArray->addVBO(std::make_unique<VertexBuffer>(
+      uptr<BufferLayout>(new BufferLayout(
+          {{LayoutObjectType::Float3, AttributeLocation::Position},
+           {LayoutObjectType::Float3, AttributeLocation::Normal}})),
+      BufferUsage::Dynamic));
+  _vertexArray->addVBO(std::make_unique<VertexBuffer>(
+      uptr<BufferLayout>(new BufferLayout(
+          {{LayoutObjectType::UInt1, AttributeLocation::DrawId}}, 1)),
+      BufferUsage::Static));
+  _vertexArray->setIndexBuffer(
+      std::make_unique<IndexBuffer>(nullptr, 0, BufferUsage::Dynamic));
+
+  _growVertices(MESH_POOL_INITIAL_VERTICES);
+  _growIndices(MESH_POOL_INITIAL_INDICES);
+  _growDrawIds(256);
+}
+
+sptr<ENDER::MeshPool> ENDER::MeshPool::create() {
+  return sptr<MeshPool>(new MeshPool());
+}
+
+bool ENDER::MeshPool::isSupported() { return GLAD_GL_VERSION_4_3; }
+
+bool ENDER::MeshPool::_allocate(std::map<uint, uint> &freeRanges, uint count,
+                                uint &offset) {
+  for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+    if (it->second < count)
+      continue;
+    offset = it->first;
+    auto rest = it->second - count;
+    freeRanges.erase(it);
+    if (rest > 0)
+      freeRanges[offset + count] = rest;
+    return true;
+  }
+  return false;
+}
+
+void ENDER::MeshPool::_free(std::map<uint, uint> &freeRanges, uint offset,
+                            uint count) {
+  if (count == 0)
+    return;
+  auto it = freeRanges.emplace(offset, count).first;
+  // Merge with the following and the preceding range.
+  auto next = std::next(it);
+  if (next != freeRanges.end() && it->first + it->second == next->first) {
+    it->second += next->second;
+    freeRanges.erase(next);
+  }
+  if (it != freeRanges.begin()) {
+    auto previous = std::prev(it);
+    if (previous->first + previous->second == it->first) {
+      previous->second += it->second;
+      freeRanges.erase(it);
+    }
+  }
+}
+
+void ENDER::MeshPool::_growVertices(uint capacity) {
+  _vertexArray->resizeVBO(0, capacity * MESH_POOL_VERTEX_SIZE * sizeof(float));
+  _free(_freeVertices, _vertexCapacity, capacity - _vertexCapacity);
+  _vertexCapacity = capacity;
+}
+
+void ENDER::MeshPool::_growIndices(uint capacity) {
+  _vertexArray->resizeIndexBuffer(capacity);
+  _free(_freeIndices, _indexCapacity, capacity - _indexCapacity);
+  _indexCapacity = capacity;
+}
+
+void ENDER::MeshPool::_growDrawIds(uint capacity) {
+  std::vector<uint32_t> ids(capacity);
+  std::iota(ids.begin(), ids.end(), 0);
+  _vertexArray->setVBOdata(1, ids.data(), ids.size() * sizeof(uint32_t));
+  _drawIdCapacity = capacity;
+}
+
+sptr<ENDER::PooledMesh> ENDER::MeshPool::allocate(uint vertexCount,
+                                                  uint indexCount) {
+  auto mesh = std::make_shared<PooledMesh>();
+  mesh->vertexCount = vertexCount;
+  mesh->indexCount = indexCount;
+  while (!_allocate(_freeVertices, vertexCount, mesh->baseVertex))
+    _growVertices(std::max(_vertexCapacity * 2, _vertexCapacity + vertexCount));
+  while (!_allocate(_freeIndices, indexCount, mesh->firstIndex))
+    _growIndices(std::max(_indexCapacity * 2, _indexCapacity + indexCount));
+  mesh->_pool = weak_from_this();
+  return mesh;
+}
+
+void ENDER::MeshPool::addDraw(const PooledMesh &mesh,
+                              const MeshDrawData &data) {
+  uint drawId = _commands.size();
+  _commands.push_back({mesh.indexCount, 1, mesh.firstIndex,
+                       (int)mesh.baseVertex, drawId});
+  _drawData.push_back(data);
+}
+
+void ENDER::MeshPool::flush(unsigned int drawType) {
+  if (_commands.empty())
+    return;
+  if (_commands.size() > _drawIdCapacity)
+    _growDrawIds(std::max<uint>(_commands.size(), _drawIdCapacity * 2));
+
+  auto commandsOffset = _commandBuffer.write(
+      _commands.data(), _commands.size() * sizeof(DrawCommand));
+  auto dataSize = _drawData.size() * sizeof(MeshDrawData);
+  auto dataOffset = _drawDataBuffer.write(_drawData.data(), dataSize);
+
+  glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, _drawDataBuffer.getIndex(),
+                    dataOffset, dataSize);
+  _vertexArray->bind();
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer.getIndex());
+  glMultiDrawElementsIndirect(drawType, GL_UNSIGNED_INT,
+                              (const void *)commandsOffset, _commands.size(),
+                              0);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+  _commands.clear();
+  _drawData.clear();
+}
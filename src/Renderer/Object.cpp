@@ -16,6 +16,7 @@ bool ENDER::Object::selected() const {
 
 void ENDER::Object::setSelected(bool selected) {
     this->_selected = selected;
+    Window::requestRedraw();
 }
 
 ENDER::Object::Object(const std::string &name, sptr<VertexArray> vertexArray) : _name(name), _vertexArray(vertexArray) {
@@ -40,10 +41,12 @@ unsigned int ENDER::Object::getId() const {
 
 void ENDER::Object::setTexture(Texture *texture) {
     _texture = texture;
+    Window::requestRedraw();
 }
 
 void ENDER::Object::setPosition(const glm::vec3 &position) {
     _position = position;
+    Window::requestRedraw();
 }
 
 glm::vec3 &ENDER::Object::getPosition() {
@@ -52,10 +55,12 @@ glm::vec3 &ENDER::Object::getPosition() {
 
 void ENDER::Object::setRotation(const glm::vec3 &rotation) {
     _rotation = rotation;
+    Window::requestRedraw();
 }
 
 void ENDER::Object::setScale(const glm::vec3 &scale) {
     _scale = scale;
+    Window::requestRedraw();
 }
 
 glm::vec3 &ENDER::Object::getRotation() {
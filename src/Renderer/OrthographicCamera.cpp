@@ -61,6 +61,10 @@ glm::vec3 ENDER::OrthographicCamera::getFront() const { return _front; }
 
 bool ENDER::OrthographicCamera::getSpotlightToggled() const { return false; }
 
+glm::vec2 ENDER::OrthographicCamera::getFramebufferSize() const {
+  return _framebufferSize;
+}
+
 glm::vec2 ENDER::OrthographicCamera::mousePositionToWorldPosition(
     const glm::vec2 &mousePosition) {
   float mouseWorldX = mousePosition.x;
@@ -1,10 +1,14 @@
 #include "../../include/Renderer/PickingTexture.hpp"
 
 #include <../../3rd/glad/include/glad/glad.h>
+#include <GpuMemory.hpp>
 #include <memory>
 
 namespace ENDER {
 PickingTexture::~PickingTexture() {
+  GpuMemory::remove(GpuResourceKind::Framebuffer, _fbo);
+  GpuMemory::remove(GpuResourceKind::Texture, _pickingTexture);
+  GpuMemory::remove(GpuResourceKind::Texture, _depthTexture);
   if (_fbo != 0) {
     glDeleteFramebuffers(1, &_fbo);
   }
@@ -60,6 +64,18 @@ void PickingTexture::init(unsigned int windowWidth, unsigned int windowHeight) {
   // Restore the default framebuffer
   glBindTexture(GL_TEXTURE_2D, 0);
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  GpuMemory::add(GpuResourceKind::Framebuffer, _fbo);
+  GpuMemory::add(GpuResourceKind::Texture, _pickingTexture);
+  GpuMemory::add(GpuResourceKind::Texture, _depthTexture);
+  _trackSizes(windowWidth, windowHeight);
+}
+
+void PickingTexture::_trackSizes(unsigned int width, unsigned int height) {
+  size_t pixels = (size_t)width * height;
+  // RGB32UI and a 32-bit float depth.
+  GpuMemory::resize(GpuResourceKind::Texture, _pickingTexture, pixels * 12);
+  GpuMemory::resize(GpuResourceKind::Texture, _depthTexture, pixels * 4);
 }
 
 void PickingTexture::updateTextureSize(unsigned int width,
@@ -80,6 +96,7 @@ void PickingTexture::updateTextureSize(unsigned int width,
                          _depthTexture, 0);
 
   glBindTexture(GL_TEXTURE_2D, 0);
+  _trackSizes(width, height);
 }
 
 void PickingTexture::enableWriting() {
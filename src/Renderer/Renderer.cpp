@@ -13,6 +13,8 @@
 #include "../../include/Renderer/BufferLayout.hpp"
 #include "../../include/Renderer/DirectionalLight.hpp"
 #include "../../include/Renderer/Framebuffer.hpp"
+#include "../../include/Renderer/FrameArena.hpp"
+#include "../../include/Renderer/GpuMemory.hpp"
 #include "../../include/Renderer/PickingTexture.hpp"
 #include "../../include/Renderer/PointLight.hpp"
 #include "../../include/Renderer/VertexBuffer.hpp"
@@ -30,24 +32,34 @@ void ENDER::Renderer::init() {
 
     ENDER::Window::setFramebufferSizeCallback(framebufferSizeCallback);
 
+    GpuMemory::OwnerScope owner("Renderer");
+    // Programs below are only checked at their first use, so they are built
+    // concurrently where the driver supports it.
+    Shader::enableParallelCompile();
+
     instance()._projectMatrix = glm::mat4(1.0f);
     instance()._projectMatrix = glm::perspective(
             glm::radians(45.0f),
             (float) Window::getWidth() / (float) Window::getHeight(), 0.1f, 100.0f);
-    instance()._simpleShader =
-            Shader::create("../resources/shaders/simpleShader.vs",
-                           "../resources/shaders/simpleShader.fs",
-                           "../resources/shaders/normalsShader.gs");
-
-    instance()._simpleShaderLine =
-            Shader::create("../resources/shaders/simpleShaderLine.vs",
-                           "../resources/shaders/simpleShaderLine.fs");
-
-    instance()._textureShader =
-            Shader::create("../resources/shaders/textureShader.vs",
-                           "../resources/shaders/textureShader.fs");
-    instance()._textureShader->use();
-    instance()._textureShader->setInt("texture1", 0);
+    instance()._objectShaders =
+            ShaderVariants::create("../resources/shaders/object.vs",
+                                   "../resources/shaders/object.fs",
+                                   "../resources/shaders/normalsShader.gs");
+    // The rest of the permutations are built when first drawn.
+    for (auto features: {0u, (unsigned int) FlatNormals, (unsigned int) Lines,
+                         (unsigned int) Picking})
+        instance()._objectShaders->get(features);
+
+    instance()._splineShader =
+            Shader::create("../resources/shaders/splineGpu.vs",
+                           "../resources/shaders/object.fs", nullptr, {"LINES"});
+
+    if (MeshPool::isSupported()) {
+        instance()._meshPoolShader =
+                Shader::create("../resources/shaders/meshPool.vs",
+                               "../resources/shaders/meshPool.fs");
+        instance()._meshPool = MeshPool::create();
+    }
 
     instance()._debugNormalsShader =
             Shader::create("../resources/shaders/normalsDebugShader.vs",
@@ -95,9 +107,9 @@ void ENDER::Renderer::init() {
 
     instance()._pickingTexture = PickingTexture::create();
     instance()._pickingTexture->init(windowSize.x, windowSize.y);
-    instance()._pickingEffect = Shader::create("../resources/shaders/picking.vs",
-                                               "../resources/shaders/picking.fs");
     glLineWidth(LINE_WIDTH);
+    spdlog::info("Shader cache: {} programs loaded, {} compiled.",
+                 ShaderCache::hits(), ShaderCache::misses());
 }
 
 unsigned int ENDER::Renderer::getPickingTextureID() {
@@ -204,22 +216,30 @@ void ENDER::Renderer::_configureLight(sptr<Shader> shader, sptr<Scene> scene) {
 void ENDER::Renderer::renderObject(sptr<Object> object, sptr<Scene> scene) {
     auto camera = scene->getCamera();
 
+    object->prepareForRender(*camera);
+
     auto currentShader = object->getShader();
 
     if (currentShader == nullptr) {
         if (object->type == Object::ObjectType::Surface) {
-            currentShader = instance()._simpleShader;
+            auto features = _instancedFeature(*object->getVertexArray());
+            // Face normals from the geometry stage are only needed when the
+            // vertices carry none.
+            if (!object->getVertexArray()->hasAttribute(AttributeLocation::Normal))
+                features |= FlatNormals;
+            if (object->getTexture() != nullptr)
+                features |= Textured;
+            currentShader = _objectShaders->get(features);
             currentShader->use();
-            currentShader->setVec3("material.diffuse", object->material.diffuse);
-            currentShader->setVec3("material.ambient", object->material.ambient);
             if (object->getTexture() != nullptr) {
-                currentShader = instance()._textureShader;
                 object->getTexture()->setAsCurrent();
-                currentShader->use();
                 currentShader->setInt("material.diffuse", 0);
+            } else {
+                currentShader->setVec3("material.diffuse", object->material.diffuse);
+                currentShader->setVec3("material.ambient", object->material.ambient);
             }
         } else if (object->type == Object::ObjectType::Line) {
-            currentShader = instance()._simpleShaderLine;
+            currentShader = _objectShaders->get(Lines | _instancedFeature(*object->getVertexArray()));
             currentShader->use();
             currentShader->setVec3("material.diffuse", object->material.diffuse);
             currentShader->setVec3("material.ambient", object->material.ambient);
@@ -241,12 +261,17 @@ void ENDER::Renderer::renderObject(sptr<Object> object, sptr<Scene> scene) {
 
     auto model = object->getTransform();
 
-    currentShader->setMat4("model", model);
+    currentShader->setMat4("model",
+                           model * object->getVertexArray()->getPositionTransform());
+    currentShader->setMat3("normalMatrix",
+                           glm::mat3(glm::transpose(glm::inverse(model))));
 
     _configureLight(currentShader, scene);
 
     currentShader->setBool("selected", object->selected());
 
+    object->bindShaderResources(*currentShader);
+
     object->getVertexArray()->bind();
 
     auto drawType = GL_TRIANGLES;
@@ -266,12 +291,36 @@ void ENDER::Renderer::renderObject(sptr<Object> object, sptr<Scene> scene) {
     if (object->type == Object::ObjectType::Line)
         drawType = GL_LINE_STRIP;
 
-    if (object->getVertexArray()->isIndexBuffer())
-        glDrawElements(drawType, object->getVertexArray()->indexCount(),
-                       GL_UNSIGNED_INT, 0);
-    else {
-        glDrawArrays(drawType, 0, object->getVertexArray()->verticesCount());
+    auto patchVertices = object->getVertexArray()->patchVertices();
+    if (patchVertices > 0) {
+        glPatchParameteri(GL_PATCH_VERTICES, patchVertices);
+        drawType = GL_PATCHES;
+    }
+
+    _draw(*object->getVertexArray(), drawType, object->getPooledMesh());
+}
+
+void ENDER::Renderer::_draw(VertexArray &vertexArray, unsigned int drawType,
+                            const PooledMesh *mesh) {
+    if (mesh != nullptr) {
+        glDrawElementsBaseVertex(drawType, mesh->indexCount, GL_UNSIGNED_INT,
+                                 (const void *) (mesh->firstIndex * sizeof(unsigned int)),
+                                 mesh->baseVertex);
+        return;
     }
+    auto instances = vertexArray.instancesCount();
+    if (vertexArray.isIndexBuffer()) {
+        if (instances > 0)
+            glDrawElementsInstanced(drawType, vertexArray.indexCount(),
+                                    GL_UNSIGNED_INT, 0, instances);
+        else
+            glDrawElements(drawType, vertexArray.indexCount(), GL_UNSIGNED_INT,
+                           0);
+    } else if (instances > 0)
+        glDrawArraysInstanced(drawType, 0, vertexArray.verticesCount(),
+                              instances);
+    else
+        glDrawArrays(drawType, 0, vertexArray.verticesCount());
 }
 
 void ENDER::Renderer::setClearColor(const glm::vec4 &color) {
@@ -307,6 +356,10 @@ void ENDER::Renderer::end() {
 
     swapBuffers();
     Window::flash();
+
+    // Nothing allocated from the frame arena may outlive the frame.
+    FrameArena::local().reset();
+    GpuMemory::nextFrame();
 }
 
 void ENDER::Renderer::setDrawType(DrawType drawType) {
@@ -318,7 +371,11 @@ glm::mat4 ENDER::Renderer::getProjectMatrix() {
 }
 
 sptr<ENDER::Shader> ENDER::Renderer::shader() {
-    return instance()._simpleShader;
+    return instance()._objectShaders->get(FlatNormals);
+}
+
+unsigned int ENDER::Renderer::_instancedFeature(VertexArray &vertexArray) {
+    return vertexArray.hasAttribute(AttributeLocation::InstanceOffset) ? Instanced : 0;
 }
 
 void ENDER::Renderer::renderScene(sptr<Scene> scene,
@@ -327,14 +384,7 @@ void ENDER::Renderer::renderScene(sptr<Scene> scene,
 
     framebuffer->bind();
     /* RENDERING TO FRAMEBUFFER */
-    for (const auto &obj: scene->getObjects()) {
-        instance().renderObject(obj, scene);
-        if (instance()._renderNormals)
-            instance().renderObject(obj, scene, instance()._debugNormalsShader);
-        if(obj->type == Object::ObjectType::Multi)
-            instance().renderObject(obj->getChildObject(), scene);
-
-    }
+    instance()._renderObjects(scene);
     framebuffer->unbind();
 
     /* RENDERING TO PICKING TEXTURE */
@@ -348,13 +398,7 @@ void ENDER::Renderer::renderScene(sptr<Scene> scene,
 void ENDER::Renderer::renderScene(sptr<Scene> scene) {
     clear();
     /* RENDERING TO DEFAULT FRAMEBUFFER */
-    for (const auto &obj: scene->getObjects()) {
-        instance().renderObject(obj, scene);
-        if (instance()._renderNormals)
-            instance().renderObject(obj, scene, instance()._debugNormalsShader);
-        if(obj->type == Object::ObjectType::Multi)
-            instance().renderObject(obj->getChildObject(), scene);
-    }
+    instance()._renderObjects(scene);
     /* RENDERING TO PICKING TEXTURE */
     clearPicking();
     for (const auto &obj: scene->getObjects()) {
@@ -363,14 +407,68 @@ void ENDER::Renderer::renderScene(sptr<Scene> scene) {
     }
 }
 
+void ENDER::Renderer::_renderObjects(sptr<Scene> scene) {
+    auto &objects = scene->getObjects();
+    auto camera = scene->getCamera();
+    std::pmr::vector<bool> batched(objects.size(), false, &FrameArena::local());
+
+    if (_meshPool != nullptr && _drawType == DrawType::Triangles) {
+        for (size_t i = 0; i < objects.size(); i++) {
+            auto &obj = objects[i];
+            if (obj->type != Object::ObjectType::Surface ||
+                obj->getShader() != nullptr || obj->getTexture() != nullptr)
+                continue;
+            obj->prepareForRender(*camera);
+            // Anything without a pooled range is drawn on its own below.
+            auto mesh = obj->getPooledMesh();
+            if (mesh == nullptr || obj->getVertexArray() == nullptr)
+                continue;
+
+            auto model = obj->getTransform();
+            MeshDrawData data;
+            data.model = model * obj->getVertexArray()->getPositionTransform();
+            data.normalMatrix = glm::mat4(glm::mat3(glm::transpose(glm::inverse(model))));
+            data.diffuse = glm::vec4(obj->material.diffuse, obj->material.shininess);
+            data.ambient = glm::vec4(obj->material.ambient, obj->selected() ? 1.0f : 0.0f);
+            data.specular = glm::vec4(obj->material.specular, 0.0f);
+            _meshPool->addDraw(*mesh, data);
+            batched[i] = true;
+        }
+
+        if (_meshPool->queuedDraws() > 0) {
+            _meshPoolShader->use();
+            _meshPoolShader->setVec3("viewPos", camera->getPosition());
+            _meshPoolShader->setMat4("view", camera->getView());
+            _meshPoolShader->setMat4("projection", camera->getProjection());
+            _configureSpotLight(_meshPoolShader, camera);
+            _configureLight(_meshPoolShader, scene);
+            _meshPool->flush(GL_TRIANGLES);
+        }
+    }
+
+    for (size_t i = 0; i < objects.size(); i++) {
+        auto &obj = objects[i];
+        if (!batched[i])
+            renderObject(obj, scene);
+        if (_renderNormals)
+            renderObject(obj, scene, _debugNormalsShader);
+        if (obj->type == Object::ObjectType::Multi)
+            renderObject(obj->getChildObject(), scene);
+    }
+}
+
 void ENDER::Renderer::renderObjectToPicking(
         sptr<Object> object, sptr<Scene> scene,
         sptr<PickingTexture> pickingTexture) {
     pickingTexture->enableWriting();
-    instance()._pickingEffect->use();
-    instance()._pickingEffect->setInt("gObjectIndex", object->getId());
-    instance()._pickingEffect->setInt("gDrawIndex", 0); // TODO: impl
-    instance().renderObject(object, scene, instance()._pickingEffect);
+    auto pickingEffect = object->getPickingShader();
+    if (pickingEffect == nullptr)
+        pickingEffect = instance()._objectShaders->get(
+                Picking | _instancedFeature(*object->getVertexArray()));
+    pickingEffect->use();
+    pickingEffect->setInt("gObjectIndex", object->getId());
+    pickingEffect->setInt("gDrawIndex", 0); // TODO: impl
+    instance().renderObject(object, scene, pickingEffect);
     pickingTexture->disableWriting();
 }
 
@@ -396,7 +494,7 @@ void ENDER::Renderer::createCircleVAO() {
 
     auto layout =
             uptr<BufferLayout>(new BufferLayout({{LayoutObjectType::Float3}}));
-    auto vbo = std::make_unique<VertexBuffer>(std::move(layout));
+    auto vbo = std::make_unique<VertexBuffer>(std::move(layout), BufferUsage::Static);
     vbo->setData(&vertices[0], vertices.size() * sizeof(float));
     circleVAO = std::make_shared<VertexArray>();
     circleVAO->addVBO(std::move(vbo));
@@ -404,11 +502,11 @@ void ENDER::Renderer::createCircleVAO() {
 
 void ENDER::Renderer::createCubeVAO() {
     auto cubeLayout =
-            uptr<BufferLayout>(new BufferLayout({{ENDER::LayoutObjectType::Float3},
-                                                 {ENDER::LayoutObjectType::Float3},
-                                                 {ENDER::LayoutObjectType::Float2}}));
+            uptr<BufferLayout>(new BufferLayout({{LayoutObjectType::Float3, AttributeLocation::Position},
+                                                 {LayoutObjectType::Float3, AttributeLocation::Normal},
+                                                 {LayoutObjectType::Float2, AttributeLocation::TexCoord}}));
 
-    auto cubeVBO = std::make_unique<VertexBuffer>(std::move(cubeLayout));
+    auto cubeVBO = std::make_unique<VertexBuffer>(std::move(cubeLayout), BufferUsage::Static);
     cubeVBO->setData(CUBE_VERTICES, sizeof(CUBE_VERTICES));
 
     cubeVAO = std::make_shared<VertexArray>();
@@ -418,7 +516,7 @@ void ENDER::Renderer::createCubeVAO() {
 void ENDER::Renderer::createGridVAO() {
     auto gridLayout = uptr<BufferLayout>(
             new ENDER::BufferLayout({ENDER::LayoutObjectType::Float3}));
-    auto gridVBO = std::make_unique<VertexBuffer>(std::move(gridLayout));
+    auto gridVBO = std::make_unique<VertexBuffer>(std::move(gridLayout), BufferUsage::Static);
     gridVBO->setData(GRID_VERTICES, sizeof(GRID_VERTICES));
 
     gridVAO = std::make_shared<ENDER::VertexArray>();
@@ -438,7 +536,7 @@ void ENDER::Renderer::createDebugSquareVAO() {
     auto layout = uptr<BufferLayout>(new BufferLayout(
             {{ENDER::LayoutObjectType::Float3},
              {ENDER::LayoutObjectType::Float2}}));
-    auto vbo = std::make_unique<VertexBuffer>(std::move(layout));
+    auto vbo = std::make_unique<VertexBuffer>(std::move(layout), BufferUsage::Static);
     vbo->setData(debugSquareVertices, sizeof(debugSquareVertices));
 
     debugSquareVAO = std::make_shared<VertexArray>();
@@ -473,6 +571,21 @@ bool ENDER::Renderer::isRenderingNormals() { return instance()._renderNormals; }
 void ENDER::Renderer::renderObject(sptr<Object> object, sptr<Scene> scene,
                                    sptr<Shader> shader) {
     auto camera = scene->getCamera();
+    auto vertexArray = object->getVertexArray();
+    auto mesh = object->getPooledMesh();
+    auto patchVertices = vertexArray->patchVertices();
+    // Patches need a program with tessellation stages, only the object's own
+    // picking program has them. Other passes draw its triangles instead.
+    if (patchVertices > 0 && shader != object->getPickingShader()) {
+        vertexArray = object->getTriangleFallback(mesh);
+        if (vertexArray == nullptr) {
+            spdlog::warn("ENDER::Renderer::renderObject: {} is drawn as "
+                         "patches and has no triangles for this pass",
+                         object->getName());
+            return;
+        }
+        patchVertices = 0;
+    }
     shader->use();
 
     shader->setFloat("time", Window::currentTime());
@@ -483,14 +596,17 @@ void ENDER::Renderer::renderObject(sptr<Object> object, sptr<Scene> scene,
 
     auto model = object->getTransform();
 
-    shader->setMat4("model", model);
-    object->getVertexArray()->bind();
+    shader->setMat4("model", model * vertexArray->getPositionTransform());
+    vertexArray->bind();
 
-    if (object->getVertexArray()->isIndexBuffer())
-        glDrawElements(GL_TRIANGLES, object->getVertexArray()->indexCount(),
-                       GL_UNSIGNED_INT, 0);
-    else
-        glDrawArrays(GL_TRIANGLES, 0, object->getVertexArray()->verticesCount());
+    unsigned int drawType = GL_TRIANGLES;
+    if (patchVertices > 0) {
+        object->bindShaderResources(*shader);
+        glPatchParameteri(GL_PATCH_VERTICES, patchVertices);
+        drawType = GL_PATCHES;
+    }
+
+    _draw(*vertexArray, drawType, mesh);
 }
 
 void ENDER::Renderer::renderObject(sptr<Object> object, sptr<Scene> scene, sptr<Framebuffer> framebuffer) {
@@ -501,3 +617,83 @@ void ENDER::Renderer::renderObject(sptr<Object> object, sptr<Scene> scene, sptr<
     if (object->isSelectable)
         instance().renderObjectToPicking(object, scene, framebuffer->getPickingTexture());
 }
+
+template <typename T> static void hashValue(uint64_t &seed, const T &value) {
+    auto bytes = reinterpret_cast<const unsigned char *>(&value);
+    for (size_t i = 0; i < sizeof(T); i++) {
+        seed ^= bytes[i];
+        seed *= 0x100000001b3ull;
+    }
+}
+
+void ENDER::Renderer::_hashObject(uint64_t &seed, Object &object,
+                                  const Camera &camera) {
+    // Applies pending changes and picks the level of detail.
+    object.prepareForRender(camera);
+
+    hashValue(seed, object.getId());
+    hashValue(seed, object.getTransform());
+    hashValue(seed, object.selected());
+    hashValue(seed, object.isSelectable);
+    hashValue(seed, object.material.ambient);
+    hashValue(seed, object.material.diffuse);
+    hashValue(seed, object.material.specular);
+    hashValue(seed, object.material.shininess);
+    hashValue(seed, object.getTexture());
+    hashValue(seed, object.getShader().get());
+    auto vertexArray = object.getVertexArray();
+    hashValue(seed, vertexArray.get());
+    if (vertexArray != nullptr)
+        hashValue(seed, vertexArray->version());
+    hashValue(seed, object.getPooledMesh());
+    hashValue(seed, object.contentVersion());
+
+    if (object.type == Object::ObjectType::Multi &&
+        object.getChildObject() != nullptr)
+        _hashObject(seed, *object.getChildObject(), camera);
+}
+
+uint64_t ENDER::Renderer::contentVersion(sptr<Scene> scene,
+                                         const std::vector<sptr<Object>> &objects) {
+    auto &renderer = instance();
+    uint64_t seed = 0xcbf29ce484222325ull;
+    hashValue(seed, renderer._drawType);
+    hashValue(seed, renderer._renderNormals);
+
+    auto camera = scene->getCamera();
+    hashValue(seed, camera->getView());
+    hashValue(seed, camera->getProjection());
+    hashValue(seed, camera->getPosition());
+    hashValue(seed, camera->getFront());
+    hashValue(seed, camera->getSpotlightToggled());
+    hashValue(seed, camera->getFramebufferSize());
+
+    // Everything _configureLight() sends to the shaders.
+    for (auto light : scene->getLights()) {
+        hashValue(seed, light);
+        if (auto pointLight = dynamic_cast<PointLight *>(light)) {
+            hashValue(seed, pointLight->position());
+            hashValue(seed, pointLight->ambient());
+            hashValue(seed, pointLight->diffuse());
+            hashValue(seed, pointLight->specular());
+            hashValue(seed, pointLight->constant());
+            hashValue(seed, pointLight->linear());
+            hashValue(seed, pointLight->quadratic());
+        } else if (auto directionalLight =
+                           dynamic_cast<DirectionalLight *>(light)) {
+            hashValue(seed, directionalLight->direction());
+            hashValue(seed, directionalLight->ambient());
+            hashValue(seed, directionalLight->diffuse());
+            hashValue(seed, directionalLight->specular());
+        }
+    }
+
+    auto hashObjects = [&](const std::vector<sptr<Object>> &list) {
+        hashValue(seed, list.size());
+        for (auto &object : list)
+            _hashObject(seed, *object, *camera);
+    };
+    hashObjects(scene->getObjects());
+    hashObjects(objects);
+    return seed;
+}
@@ -1,4 +1,5 @@
 #include <../../include/Renderer/Scene.hpp>
+#include <../../include/Renderer/Window.hpp>
 #include <../../3rd/glm/glm/gtc/matrix_transform.hpp>
 
 ENDER::Scene::Scene() { spdlog::debug("Creating scene."); }
@@ -16,17 +17,27 @@ glm::mat4 ENDER::Scene::calculateView() const {
 
 std::vector<sptr<ENDER::Object>> &ENDER::Scene::getObjects() { return _objects; }
 
-void ENDER::Scene::addObject(sptr<Object> object) { _objects.push_back(object); }
+void ENDER::Scene::addObject(sptr<Object> object) {
+    _objects.push_back(object);
+    Window::requestRedraw();
+}
 
-void ENDER::Scene::setCamera(sptr<Camera> camera) { _camera = camera; }
+void ENDER::Scene::setCamera(sptr<Camera> camera) {
+    _camera = camera;
+    Window::requestRedraw();
+}
 
 sptr<ENDER::Camera> ENDER::Scene::getCamera() { return _camera; }
 
-void ENDER::Scene::addLight(Light *light) { _lights.push_back(light); }
+void ENDER::Scene::addLight(Light *light) {
+    _lights.push_back(light);
+    Window::requestRedraw();
+}
 
 const std::vector<ENDER::Light *> &ENDER::Scene::getLights() { return _lights; }
 
 void ENDER::Scene::deleteObject(const sptr<ENDER::Object>& object) {
     auto it = std::find(_objects.begin(),_objects.end(),object);
     _objects.erase(it);
+    Window::requestRedraw();
 }
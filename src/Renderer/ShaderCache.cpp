@@ -0,0 +1,147 @@
+#include <ShaderCache.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <vector>
+
+std::string ENDER::ShaderCache::_directory = "../cache/shaders";
+bool ENDER::ShaderCache::_enabled = true;
+unsigned int ENDER::ShaderCache::_hits = 0;
+unsigned int ENDER::ShaderCache::_misses = 0;
+
+// File layout: magic, binary format, binary length, binary.
+static const uint32_t CACHE_MAGIC = 0x42505345; // "ESPB"
+
+struct CacheHeader {
+  uint32_t magic;
+  uint32_t format;
+  uint32_t length;
+};
+
+bool ENDER::ShaderCache::isSupported() {
+  if (!GLAD_GL_VERSION_4_1)
+    return false;
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+uint64_t ENDER::ShaderCache::hash(const std::string &data, uint64_t seed) {
+  uint64_t res = seed;
+  for (unsigned char c : data) {
+    res ^= c;
+    res *= 0x100000001b3ull;
+  }
+  return res;
+}
+
+uint64_t ENDER::ShaderCache::driverHash() {
+  static uint64_t res = 0;
+  if (res != 0)
+    return res;
+  std::string driver;
+  for (auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+    auto value = glGetString(name);
+    driver += value != nullptr ? (const char *)value : "";
+    driver += '\n';
+  }
+  res = hash(driver);
+  return res;
+}
+
+std::string ENDER::ShaderCache::_path(uint64_t key) {
+  std::stringstream path;
+  path << _directory << "/" << std::hex << std::setw(16) << std::setfill('0')
+       << key << ".bin";
+  return path.str();
+}
+
+unsigned int ENDER::ShaderCache::load(uint64_t key) {
+  if (!isEnabled()) {
+    _misses++;
+    return 0;
+  }
+  auto path = _path(key);
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    _misses++;
+    return 0;
+  }
+
+  CacheHeader header;
+  std::vector<char> binary;
+  bool valid = file.read((char *)&header, sizeof(header)) &&
+               header.magic == CACHE_MAGIC && header.length > 0;
+  if (valid) {
+    binary.resize(header.length);
+    valid = (bool)file.read(binary.data(), header.length);
+  }
+  file.close();
+  if (!valid) {
+    spdlog::warn("ShaderCache: corrupted entry {}", path);
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    _misses++;
+    return 0;
+  }
+
+  unsigned int program = glCreateProgram();
+  glProgramBinary(program, header.format, binary.data(), header.length);
+  GLint success;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (!success) {
+    // Formats can be dropped by the driver without a version change.
+    spdlog::info("ShaderCache: binary {} rejected by the driver", path);
+    glDeleteProgram(program);
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    _misses++;
+    return 0;
+  }
+  _hits++;
+  return program;
+}
+
+void ENDER::ShaderCache::store(uint64_t key, unsigned int program) {
+  if (!isEnabled())
+    return;
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return;
+
+  std::vector<char> binary(length);
+  GLenum format;
+  glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+  std::error_code error;
+  std::filesystem::create_directories(_directory, error);
+  if (error) {
+    spdlog::warn("ShaderCache: can't create {}: {}", _directory,
+                 error.message());
+    return;
+  }
+  // Written to a temporary file first, so a crash leaves no partial entry.
+  auto path = _path(key);
+  auto temporary = path + ".tmp";
+  std::ofstream file(temporary, std::ios::binary);
+  CacheHeader header{CACHE_MAGIC, format, (uint32_t)length};
+  file.write((const char *)&header, sizeof(header));
+  file.write(binary.data(), length);
+  file.close();
+  if (!file) {
+    spdlog::warn("ShaderCache: can't write {}", temporary);
+    std::filesystem::remove(temporary, error);
+    return;
+  }
+  std::filesystem::rename(temporary, path, error);
+}
+
+void ENDER::ShaderCache::clear() {
+  std::error_code error;
+  std::filesystem::remove_all(_directory, error);
+  spdlog::info("ShaderCache: cleared {}", _directory);
+}
@@ -0,0 +1,72 @@
+#include <ShaderSource.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+bool ENDER::ShaderSource::_append(std::string &code, const std::string &path,
+                                  std::vector<std::string> &files) {
+  std::ifstream file(path);
+  if (!file) {
+    spdlog::error("SHADER::FILE_NOT_SUCCESSFULLY_READ: {}", path);
+    return false;
+  }
+  auto index = files.size();
+  files.push_back(path);
+
+  std::string line;
+  unsigned int number = 0;
+  while (std::getline(file, line)) {
+    number++;
+    auto start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+      code += line + "\n";
+      continue;
+    }
+
+    auto open = line.find('"', start);
+    auto close = open == std::string::npos ? open : line.find('"', open + 1);
+    if (close == std::string::npos) {
+      spdlog::error("SHADER: malformed #include at {}:{}", path, number);
+      code += "\n";
+      continue;
+    }
+    auto included = (std::filesystem::path(path).parent_path() /
+                     line.substr(open + 1, close - open - 1))
+                        .lexically_normal()
+                        .string();
+    if (std::find(files.begin(), files.end(), included) != files.end()) {
+      code += "\n";
+      continue;
+    }
+    code += "#line 1 " + std::to_string(files.size()) + "\n";
+    _append(code, included, files);
+    code += "#line " + std::to_string(number + 1) + " " +
+            std::to_string(index) + "\n";
+  }
+  return true;
+}
+
+std::string ENDER::ShaderSource::load(const std::string &path,
+                                      const std::vector<std::string> &defines) {
+  std::string code;
+  std::vector<std::string> files;
+  _append(code, std::filesystem::path(path).lexically_normal().string(), files);
+  if (defines.empty())
+    return code;
+
+  // #version has to stay the first directive.
+  size_t position = 0;
+  auto version = code.find("#version");
+  if (version != std::string::npos &&
+      (version == 0 || code[version - 1] == '\n'))
+    position = code.find('\n', version) + 1;
+  auto line = std::count(code.begin(), code.begin() + position, '\n') + 1;
+
+  std::string block;
+  for (auto &define : defines)
+    block += "#define " + define + "\n";
+  block += "#line " + std::to_string(line) + " 0\n";
+  code.insert(position, block);
+  return code;
+}
@@ -0,0 +1,44 @@
+#include <ShaderVariants.hpp>
+
+ENDER::ShaderVariants::ShaderVariants(const std::string &vertexPath,
+                                      const std::string &fragmentPath,
+                                      const std::string &geometryPath)
+    : _vertexPath(vertexPath), _fragmentPath(fragmentPath),
+      _geometryPath(geometryPath) {}
+
+sptr<ENDER::ShaderVariants>
+ENDER::ShaderVariants::create(const std::string &vertexPath,
+                              const std::string &fragmentPath,
+                              const std::string &geometryPath) {
+  return std::make_shared<ShaderVariants>(vertexPath, fragmentPath,
+                                          geometryPath);
+}
+
+sptr<ENDER::Shader> ENDER::ShaderVariants::get(unsigned int features) {
+  auto it = _variants.find(features);
+  if (it != _variants.end())
+    return it->second;
+
+  auto geometry = (features & FlatNormals) && !_geometryPath.empty()
+                      ? _geometryPath.c_str()
+                      : nullptr;
+  auto shader = Shader::create(_vertexPath.c_str(), _fragmentPath.c_str(),
+                               geometry, defines(features));
+  _variants[features] = shader;
+  return shader;
+}
+
+std::vector<std::string>
+ENDER::ShaderVariants::defines(unsigned int features) {
+  static const std::pair<ShaderFeature, const char *> names[] = {
+      {Textured, "TEXTURED"},
+      {Lines, "LINES"},
+      {Picking, "PICKING"},
+      {FlatNormals, "FLAT_NORMALS"},
+      {Instanced, "INSTANCED"}};
+  std::vector<std::string> res;
+  for (auto &[feature, name] : names)
+    if (features & feature)
+      res.push_back(name);
+  return res;
+}
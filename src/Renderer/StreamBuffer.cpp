@@ -0,0 +1,137 @@
+#include <StreamBuffer.hpp>
+#include <algorithm>
+#include <cstring>
+
+// Timeout of a single glClientWaitSync, the wait repeats until the fence signals.
+static const GLuint64 STREAM_BUFFER_WAIT_SLICE = 100000000; // 100 ms
+
+ENDER::StreamBuffer::StreamBuffer(unsigned int target, size_t minRegionSize)
+    : _target(target),
+      _persistent(GLAD_GL_ARB_buffer_storage && glBufferStorage != nullptr),
+      _minRegionSize(minRegionSize) {}
+
+ENDER::StreamBuffer &ENDER::StreamBuffer::uploads() {
+  static StreamBuffer buffer(GL_COPY_READ_BUFFER,
+                             STREAM_BUFFER_UPLOAD_REGION_SIZE);
+  return buffer;
+}
+
+ENDER::StreamBuffer::~StreamBuffer() {
+  GpuMemory::remove(GpuResourceKind::Buffer, _id);
+  _release();
+}
+
+void ENDER::StreamBuffer::_release() {
+  for (auto &fence : _fences) {
+    if (fence)
+      glDeleteSync(fence);
+    fence = nullptr;
+  }
+  if (_id == 0)
+    return;
+  if (_mapped) {
+    glBindBuffer(_target, _id);
+    glUnmapBuffer(_target);
+    _mapped = nullptr;
+  }
+  glDeleteBuffers(1, &_id);
+  spdlog::info("Deallocated stream buffer. Index: {}.", _id);
+  _id = 0;
+}
+
+void ENDER::StreamBuffer::_allocate(size_t regionSize) {
+  auto previous = _id;
+  _release();
+  _regionSize = (regionSize + STREAM_BUFFER_ALIGNMENT - 1) /
+                STREAM_BUFFER_ALIGNMENT * STREAM_BUFFER_ALIGNMENT;
+  _region = 0;
+  _head = 0;
+
+  glGenBuffers(1, &_id);
+  _generation++;
+  glBindBuffer(_target, _id);
+  if (_persistent) {
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(_target, capacity(), nullptr, flags);
+    _mapped = (char *)glMapBufferRange(_target, 0, capacity(), flags);
+  } else
+    glBufferData(_target, capacity(), nullptr, GL_STREAM_DRAW);
+  if (previous)
+    GpuMemory::move(GpuResourceKind::Buffer, previous, _id, capacity());
+  else
+    GpuMemory::add(GpuResourceKind::Buffer, _id, capacity());
+  spdlog::info("Created stream buffer. Index: {}. Capacity: {}. Persistent: {}",
+               _id, capacity(), _persistent);
+}
+
+bool ENDER::StreamBuffer::_waitRegion(unsigned int region, bool wait) {
+  auto &fence = _fences[region];
+  if (!fence)
+    return true;
+
+  auto status = glClientWaitSync(fence, 0, 0);
+  if (status == GL_TIMEOUT_EXPIRED) {
+    if (!wait)
+      return false;
+    spdlog::debug("Stream buffer {} waits for region {}", _id, region);
+    do
+      status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                STREAM_BUFFER_WAIT_SLICE);
+    while (status == GL_TIMEOUT_EXPIRED);
+  }
+  if (status == GL_WAIT_FAILED)
+    spdlog::error("Stream buffer {}: waiting for region {} failed", _id,
+                  region);
+
+  glDeleteSync(fence);
+  fence = nullptr;
+  return true;
+}
+
+void ENDER::StreamBuffer::_nextRegion() {
+  // Everything issued so far may read the region being left.
+  auto &left = _fences[_region];
+  if (left)
+    glDeleteSync(left);
+  left = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  auto region = (_region + 1) % STREAM_BUFFER_REGIONS;
+  if (_persistent)
+    _waitRegion(region, true);
+  else if (!_waitRegion(region, false)) {
+    // The next region is busy: let the driver hand out fresh storage instead
+    // of stalling on the old one.
+    glBindBuffer(_target, _id);
+    glBufferData(_target, capacity(), nullptr, GL_STREAM_DRAW);
+    for (auto &fence : _fences) {
+      if (fence)
+        glDeleteSync(fence);
+      fence = nullptr;
+    }
+    region = 0;
+  }
+  _region = region;
+  _head = 0;
+}
+
+size_t ENDER::StreamBuffer::write(const void *data, size_t size) {
+  auto aligned = (size + STREAM_BUFFER_ALIGNMENT - 1) /
+                 STREAM_BUFFER_ALIGNMENT * STREAM_BUFFER_ALIGNMENT;
+  if (aligned > _regionSize)
+    _allocate(std::max({aligned, _regionSize * 2, _minRegionSize}));
+  else if (_head + aligned > _regionSize)
+    _nextRegion();
+
+  auto offset = _region * _regionSize + _head;
+  _head += aligned;
+  if (!data || size == 0)
+    return offset;
+  if (_persistent)
+    std::memcpy(_mapped + offset, data, size);
+  else {
+    glBindBuffer(_target, _id);
+    glBufferSubData(_target, offset, size, data);
+  }
+  return offset;
+}
@@ -1,6 +1,7 @@
 #include "../../3rd/spdlog/include/spdlog/spdlog.h"
 #include <../../include/Renderer/Texture.hpp>
 #include <../../3rd/glad/include/glad/glad.h>
+#include <GpuMemory.hpp>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <../../3rd/stb/stb_image.h>
@@ -8,6 +9,7 @@
 ENDER::Texture::Texture()
 {
   glGenTextures(1, &_id);
+  GpuMemory::add(GpuResourceKind::Texture, _id);
   glBindTexture(GL_TEXTURE_2D, _id);
   // set the texture wrapping parameters
   glTexParameteri(
@@ -21,6 +23,8 @@ ENDER::Texture::Texture()
 
 ENDER::Texture::~Texture() {
   spdlog::debug("Deallocation Texture[id: {}]", _id);
+  GpuMemory::remove(GpuResourceKind::Texture, _id);
+  glDeleteTextures(1, &_id);
 }
 
 void ENDER::Texture::loadFromFile(const std::string &texturePath,
@@ -36,6 +40,9 @@ void ENDER::Texture::loadFromFile(const std::string &texturePath,
     glTexImage2D(GL_TEXTURE_2D, 0, type, _width, _height, 0, type,
                  GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
+    // The mipmap chain adds about a third.
+    GpuMemory::resize(GpuResourceKind::Texture, _id,
+                      (size_t)_width * _height * _nrChannels * 4 / 3);
     spdlog::info("Loaded texture[index: {}, path: {}]", _id, texturePath);
   }
   else
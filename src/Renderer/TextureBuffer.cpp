@@ -0,0 +1,55 @@
+#include <../../3rd/glad/include/glad/glad.h>
+#include <../../include/Renderer/TextureBuffer.hpp>
+#include <GpuMemory.hpp>
+
+ENDER::TextureBuffer::TextureBuffer(unsigned int internalFormat)
+    : _internalFormat(internalFormat)
+{
+  glGenBuffers(1, &_bufferId);
+  glGenTextures(1, &_textureId);
+  GpuMemory::add(GpuResourceKind::Buffer, _bufferId);
+  GpuMemory::add(GpuResourceKind::Texture, _textureId);
+  spdlog::info("Created TextureBuffer. Index: {}", _textureId);
+}
+
+ENDER::TextureBuffer::~TextureBuffer()
+{
+  GpuMemory::remove(GpuResourceKind::Texture, _textureId);
+  GpuMemory::remove(GpuResourceKind::Buffer, _bufferId);
+  glDeleteTextures(1, &_textureId);
+  glDeleteBuffers(1, &_bufferId);
+  spdlog::info("Deallocated TextureBuffer. Index: {}.", _textureId);
+}
+
+void ENDER::TextureBuffer::setData(const float *data, unsigned int size)
+{
+  glBindBuffer(GL_TEXTURE_BUFFER, _bufferId);
+  if (size != _size)
+  {
+    glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, _textureId);
+    glTexBuffer(GL_TEXTURE_BUFFER, _internalFormat, _bufferId);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    _size = size;
+    GpuMemory::resize(GpuResourceKind::Buffer, _bufferId, size);
+  }
+  else
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ENDER::TextureBuffer::setSubData(unsigned int offset, const float *data,
+                                      unsigned int size)
+{
+  spdlog::debug("Updating TextureBuffer data. Index: {}. Offset: {}. Size of data: {}", _textureId, offset, size);
+  glBindBuffer(GL_TEXTURE_BUFFER, _bufferId);
+  glBufferSubData(GL_TEXTURE_BUFFER, offset, size, data);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ENDER::TextureBuffer::bind(unsigned int unit) const
+{
+  glActiveTexture(GL_TEXTURE0 + unit);
+  glBindTexture(GL_TEXTURE_BUFFER, _textureId);
+  glActiveTexture(GL_TEXTURE0);
+}
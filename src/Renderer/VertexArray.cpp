@@ -4,12 +4,16 @@
 
 ENDER::VertexArray::VertexArray() {
   glGenVertexArrays(1, &_id);
+  GpuMemory::add(GpuResourceKind::VertexArray, _id);
   spdlog::info("VAO created. Index: {}", _id);
 }
 
 void ENDER::VertexArray::bind() const {
   // spdlog::debug("Bind VAO. Index: {}", m_id);
   glBindVertexArray(_id);
+  for (uint i = 0; i < _vbos.size(); i++)
+    if (_bindings[i].generation != _vbos[i]->generation())
+      _specifyAttributes(i);
 }
 
 void ENDER::VertexArray::unbind() const {
@@ -17,21 +21,50 @@ void ENDER::VertexArray::unbind() const {
   glBindVertexArray(0);
 }
 
-void ENDER::VertexArray::addVBO(uptr<VertexBuffer> vbo) {
-  bind();
+void ENDER::VertexArray::_specifyAttributes(uint vboIndex) const {
+  auto &vbo = _vbos[vboIndex];
+  auto &binding = _bindings[vboIndex];
   vbo->bind();
+  uint k = 0;
+  for (auto &el : vbo->getLayout()) {
+    if (BufferLayout::isInteger(el.type)) {
+      glVertexAttribIPointer(binding.locations[k++],
+                             BufferLayout::convertTypeToNumberOfElements(el.type),
+                             BufferLayout::convertTypeToGLType(el.type),
+                             el.stride, (const void *)el.offset);
+      continue;
+    }
+    glVertexAttribPointer(binding.locations[k++],
+                          BufferLayout::convertTypeToNumberOfElements(el.type),
+                          BufferLayout::convertTypeToGLType(el.type),
+                          BufferLayout::isNormalized(el.type) ? GL_TRUE
+                                                              : GL_FALSE,
+                          el.stride, (const void *)el.offset);
+  }
+  binding.generation = vbo->generation();
+}
+
+uint ENDER::VertexArray::addVBO(uptr<VertexBuffer> vbo) {
+  bind();
   spdlog::info("Adding VBO[Index: {}] to VAO[Index: {}]", vbo->getIndex(), _id);
+  auto divisor = vbo->getLayout().getDivisor();
+  BufferBinding binding;
   for (auto &el : vbo->getLayout()) {
     spdlog::debug("Applying vertex attribue with type {}",
                   BufferLayout::convertTypeToString(el.type));
-    glVertexAttribPointer(_index,
-                          BufferLayout::convertTypeToNumberOfElements(el.type),
-                          BufferLayout::convertTypeToGLType(el.type), GL_FALSE,
-                          el.stride, (const void *)el.offset);
-    glEnableVertexAttribArray(_index);
-    _index++;
+    unsigned int location = el.location >= 0 ? el.location : _index;
+    glEnableVertexAttribArray(location);
+    if (divisor > 0)
+      glVertexAttribDivisor(location, divisor);
+    binding.locations.push_back(location);
+    _attributeMask |= 1u << location;
+    _index = location + 1;
   }
   _vbos.push_back(std::move(vbo));
+  _bindings.push_back(std::move(binding));
+  _specifyAttributes(_vbos.size() - 1);
+  _version++;
+  return _vbos.size() - 1;
 }
 
 bool ENDER::VertexArray::isIndexBuffer() const {
@@ -39,9 +72,20 @@ bool ENDER::VertexArray::isIndexBuffer() const {
 }
 
 uint ENDER::VertexArray::verticesCount() {
+  for (auto &vbo : _vbos)
+    if (vbo->getLayout().getDivisor() == 0)
+      return vbo->count();
+  return _vertexCount;
+}
+
+uint ENDER::VertexArray::instancesCount() {
   uint res = 0;
   for (auto &vbo : _vbos) {
-    res += vbo->count();
+    auto divisor = vbo->getLayout().getDivisor();
+    if (divisor == 0)
+      continue;
+    auto instances = vbo->count() * divisor;
+    res = res == 0 ? instances : std::min(res, instances);
   }
   return res;
 }
@@ -56,9 +100,45 @@ unsigned int ENDER::VertexArray::indexCount() {
   return _indexBuffer->getCount();
 }
 
-void ENDER::VertexArray::setVBOdata(uint vboIndex, float *data, uint size) {
+void ENDER::VertexArray::setVBOdata(uint vboIndex, const void *data,
+                                    uint size) {
   if (vboIndex < _vbos.size())
     _vbos.at(vboIndex).get()->setData(data, size);
+  _version++;
+}
+
+void ENDER::VertexArray::setVBOsubData(uint vboIndex, uint offset,
+                                       const void *data, uint size) {
+  if (vboIndex < _vbos.size())
+    _vbos.at(vboIndex).get()->setSubData(offset, data, size);
+  _version++;
+}
+
+void ENDER::VertexArray::appendVBOdata(uint vboIndex, const void *data,
+                                       uint size) {
+  if (vboIndex < _vbos.size())
+    _vbos.at(vboIndex).get()->append(data, size);
+  _version++;
+}
+
+void ENDER::VertexArray::resizeVBO(uint vboIndex, uint size) {
+  if (vboIndex < _vbos.size())
+    _vbos.at(vboIndex).get()->resize(size);
+  _version++;
+}
+
+void ENDER::VertexArray::setIndexSubData(uint first,
+                                         const unsigned int *indices,
+                                         uint count) {
+  if (_indexBuffer != nullptr)
+    _indexBuffer->setSubData(first, indices, count);
+  _version++;
+}
+
+void ENDER::VertexArray::resizeIndexBuffer(uint count) {
+  if (_indexBuffer != nullptr)
+    _indexBuffer->resize(count);
+  _version++;
 }
 
 void ENDER::VertexArray::setIndexBuffer(uptr<IndexBuffer> indexBuffer) {
@@ -66,6 +146,7 @@ void ENDER::VertexArray::setIndexBuffer(uptr<IndexBuffer> indexBuffer) {
   indexBuffer->bind();
 
   _indexBuffer = std::move(indexBuffer);
+  _version++;
   unbind();
   spdlog::info("Adding IndexBuffer[Index: {}] to VAO[Index: {}]",
                _indexBuffer->getIndex(), _id);
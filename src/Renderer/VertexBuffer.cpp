@@ -1,23 +1,99 @@
 #include <../../include/Renderer/VertexBuffer.hpp>
 #include <../../3rd/spdlog/include/spdlog/spdlog.h>
 #include <../../3rd/glad/include/glad/glad.h>
+#include <algorithm>
 
-ENDER::VertexBuffer::VertexBuffer(uptr<BufferLayout> layout)
-    : _layout(std::move(layout))
+ENDER::VertexBuffer::VertexBuffer(uptr<BufferLayout> layout, BufferUsage usage)
+    : _layout(std::move(layout)), _usage(usage)
 {
   glGenBuffers(1, &_id);
+  GpuMemory::add(GpuResourceKind::Buffer, _id);
   spdlog::info("Created VBO. Index: {}", _id);
 }
 
-void ENDER::VertexBuffer::setData(float *data, unsigned int size)
+void ENDER::VertexBuffer::setData(const void *data, unsigned int size)
 {
   _count = size/_layout->getStride();
+  _size = size;
 
   spdlog::debug("Setting data to VBO. Index: {}. Size of data: {} -> Count of elements: {}", _id, size, _count);
   bind();
 
-  glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
-  // unbind();
+  // Dynamic and stream storage is reused while the data fits and is not much
+  // smaller.
+  bool keep = _usage != BufferUsage::Static && size <= _capacity && size * 4 >= _capacity;
+  if (!keep)
+  {
+    _capacity = size;
+    // Stream storage is filled by the copy below.
+    bool staged = _usage == BufferUsage::Stream && data;
+    glBufferData(GL_ARRAY_BUFFER, size, staged ? nullptr : data, convertUsageToGLUsage(_usage));
+    GpuMemory::resize(GpuResourceKind::Buffer, _id, _capacity);
+    if (!staged)
+      return;
+  }
+  if (!data || size == 0)
+    return;
+  if (_usage != BufferUsage::Stream)
+  {
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+    return;
+  }
+
+  // The upload is a memcpy into the shared ring, the copy runs on the GPU
+  // without waiting for draws that still read the old data.
+  auto &uploads = StreamBuffer::uploads();
+  auto offset = uploads.write(data, size);
+  glBindBuffer(GL_COPY_READ_BUFFER, uploads.getIndex());
+  glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, 0, size);
+}
+
+void ENDER::VertexBuffer::setSubData(unsigned int offset, const void *data,
+                                     unsigned int size)
+{
+  spdlog::debug("Updating VBO data. Index: {}. Offset: {}. Size of data: {}", _id, offset, size);
+  bind();
+
+  glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
+
+void ENDER::VertexBuffer::append(const void *data, unsigned int size)
+{
+  spdlog::debug("Appending to VBO. Index: {}. Size of data: {}", _id, size);
+  if (_size + size > _capacity)
+    _grow(std::max(_size + size, _capacity * 2));
+  bind();
+  glBufferSubData(GL_ARRAY_BUFFER, _size, size, data);
+  _size += size;
+  _count = _size / _layout->getStride();
+}
+
+void ENDER::VertexBuffer::resize(unsigned int size)
+{
+  if (size > _capacity)
+    _grow(std::max(size, _capacity * 2));
+  _size = size;
+  _count = _size / _layout->getStride();
+}
+
+void ENDER::VertexBuffer::_grow(uint capacity)
+{
+  unsigned int id;
+  glGenBuffers(1, &id);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+  glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, convertUsageToGLUsage(_usage));
+  if (_size > 0)
+  {
+    glBindBuffer(GL_COPY_READ_BUFFER, _id);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, _size);
+  }
+  spdlog::debug("Grown VBO. Index: {} -> {}. Capacity: {} -> {}", _id, id, _capacity, capacity);
+  glDeleteBuffers(1, &_id);
+  GpuMemory::move(GpuResourceKind::Buffer, _id, id, capacity);
+  _id = id;
+  _generation++;
+  _capacity = capacity;
 }
 
 void ENDER::VertexBuffer::bind()
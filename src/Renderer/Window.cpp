@@ -2,11 +2,32 @@
 #include <../../3rd/spdlog/include/spdlog/spdlog.h>
 
 #include <../../include/Renderer/Window.hpp>
+#include <algorithm>
+#include <imgui.h>
 
 ENDER::Window::Window() {}
 
+void ENDER::Window::_onEvent() {
+  _redrawFrames = std::max(_redrawFrames, REDRAW_FRAMES_AFTER_EVENT);
+}
+
+void ENDER::Window::_trackHeldInput(int action) {
+  if (action == GLFW_PRESS)
+    _heldInputs++;
+  else if (action == GLFW_RELEASE)
+    _heldInputs = std::max(_heldInputs - 1, 0);
+}
+
+void ENDER::Window::_focusCallback(GLFWwindow *window, int focused) {
+  // Releases are not reported to unfocused windows.
+  if (!focused)
+    _heldInputs = 0;
+  _onEvent();
+}
+
 void ENDER::Window::_posCursorCallback(GLFWwindow *window, double xpos,
                                        double ypos) {
+  _onEvent();
   for (auto &func : _mousePosCallbacks) {
     func.second(xpos, ypos);
   }
@@ -15,6 +36,7 @@ void ENDER::Window::_posCursorCallback(GLFWwindow *window, double xpos,
 
 void ENDER::Window::_scrollCallback(GLFWwindow *window, double offsetX,
                                     double offsetY) {
+  _onEvent();
   for (auto &func : _scrollCallbacks) {
     func.second(offsetX, offsetY);
   }
@@ -22,6 +44,8 @@ void ENDER::Window::_scrollCallback(GLFWwindow *window, double offsetX,
 
 void ENDER::Window::_clickCursorCallback(GLFWwindow *window, int button,
                                          int action, int mods) {
+  _onEvent();
+  _trackHeldInput(action);
   MouseButton _button;
   switch (button) {
   case GLFW_MOUSE_BUTTON_RIGHT:
@@ -42,6 +66,8 @@ void ENDER::Window::_clickCursorCallback(GLFWwindow *window, int button,
 
 void ENDER::Window::_inputCallback(GLFWwindow *window, int key, int scancode,
                                    int action, int mods) {
+  _onEvent();
+  _trackHeldInput(action);
   EventStatus _status = glfwActionToEventStatus(action);
   for (auto &func : _inputCallbacks) {
     func.second(key, _status);
@@ -50,16 +76,29 @@ void ENDER::Window::_inputCallback(GLFWwindow *window, int key, int scancode,
 
 void ENDER::Window::init(unsigned int width, unsigned int height) {
   glfwInit();
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  auto createWindow = [&](int major, int minor) {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 #ifdef __APPLE__
-  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-  glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GL_FALSE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GL_FALSE);
 #endif
-  instance()._window =
-      glfwCreateWindow(width, height, "ENDER test", NULL, NULL);
+    return glfwCreateWindow(width, height, "ENDER test", NULL, NULL);
+  };
+
+  // 4.3 enables compute shaders, 4.1 (the most macOS offers) tessellation and
+  // program binaries, everything else only needs 3.3.
+  instance()._window = createWindow(4, 3);
+  if (instance()._window == NULL) {
+    spdlog::warn("OpenGL 4.3 context is not available, falling back to 4.1");
+    instance()._window = createWindow(4, 1);
+  }
+  if (instance()._window == NULL) {
+    spdlog::warn("OpenGL 4.1 context is not available, falling back to 3.3");
+    instance()._window = createWindow(3, 3);
+  }
   if (instance()._window == NULL) {
     spdlog::error("Failed to create GLFW window");
     glfwTerminate();
@@ -90,6 +129,22 @@ void ENDER::Window::init(unsigned int width, unsigned int height) {
                         [](GLFWwindow *window, double offsetX, double offsetY) {
                           instance()._scrollCallback(window, offsetX, offsetY);
                         });
+  glfwSetWindowFocusCallback(instance()._window,
+                             [](GLFWwindow *window, int focused) {
+                               instance()._focusCallback(window, focused);
+                             });
+  // Only to wake up on-demand redraws, ImGui chains its own handling to these.
+  glfwSetCharCallback(instance()._window,
+                      [](GLFWwindow *window, unsigned int codepoint) {
+                        instance()._onEvent();
+                      });
+  glfwSetCursorEnterCallback(instance()._window,
+                             [](GLFWwindow *window, int entered) {
+                               instance()._onEvent();
+                             });
+  glfwSetWindowRefreshCallback(instance()._window, [](GLFWwindow *window) {
+    instance()._onEvent();
+  });
 }
 
 int ENDER::Window::addMousePosCallback(mousePosCallback callback) {
@@ -144,6 +199,7 @@ void ENDER::Window::setFramebufferSizeCallback(
 void ENDER::Window::__framebufferSizeCallback(GLFWwindow *window, int width,
                                               int height) {
   instance()._framebufferSizeCallback(width, height);
+  instance()._onEvent();
   instance()._width = width;
   instance()._height = height;
   spdlog::debug("Window resized. [width: {}, height: {}]", width, height);
@@ -238,6 +294,37 @@ void ENDER::Window::flash() {
   auto currentTime = glfwGetTime();
   instance()._deltaTime = currentTime - instance()._lastFrame;
   instance()._lastFrame = currentTime;
+  if (instance()._redrawFrames > 0)
+    instance()._redrawFrames--;
+}
+
+void ENDER::Window::setRedrawOnDemand(bool value) {
+  instance()._redrawOnDemand = value;
+  instance()._onEvent();
+}
+
+bool ENDER::Window::isRedrawOnDemand() { return instance()._redrawOnDemand; }
+
+void ENDER::Window::requestRedraw(unsigned int frames) {
+  instance()._redrawFrames = std::max(instance()._redrawFrames, frames);
+}
+
+bool ENDER::Window::needsRedraw() {
+  return instance()._redrawFrames > 0 || instance()._heldInputs > 0;
+}
+
+void ENDER::Window::waitForRedraw() {
+  auto &window = instance();
+  if (!window._redrawOnDemand)
+    return;
+  auto start = glfwGetTime();
+  while (!needsRedraw() && !glfwWindowShouldClose(window._window)) {
+    glfwWaitEventsTimeout(REDRAW_WAIT_TIMEOUT);
+    if (ImGui::GetCurrentContext() != nullptr &&
+        ImGui::GetIO().WantTextInput)
+      break;
+  }
+  window._lastFrame += glfwGetTime() - start;
 }
 
 double ENDER::Window::deltaTime() { return instance()._deltaTime; }
@@ -1,9 +1,40 @@
 #include "MyApplication.hpp"
 #include "spdlog/common.h"
 #define GLM_ENABLE_EXPERIMENTAL
+#ifdef ENDER_COUNT_HEAP_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+#endif
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 800;
 
+#ifdef ENDER_COUNT_HEAP_ALLOCATIONS
+// Debug builds only. The array and nothrow forms forward to these by default,
+// so every allocation of the program is counted.
+void *operator new(size_t size) {
+  ENDER::FrameArena::countHeapAllocation();
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+  ENDER::FrameArena::countHeapAllocation();
+  size_t align = static_cast<size_t>(alignment);
+  size = (size + align - 1) / align * align;
+  if (void *p = std::aligned_alloc(align, size ? size : align))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+#endif
+
 int main() {
   spdlog::set_level(spdlog::level::info);
     MyApplication app{SCR_WIDTH, SCR_HEIGHT};